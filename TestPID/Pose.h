@@ -1,10 +0,0 @@
-#ifndef POSE_H
-#define POSE_H
-
-struct pose{
-    float x;
-    float y;
-    float theta;
-};
-
-#endif // POSE_H
@@ -1,9 +1,31 @@
-#include "PIDController.h"
-#include "RotationalController.h"
+#include "../src/mobility/src/PID.h"
 #include <cmath>
 #include <iostream>
 #include <string>
 
+// The gains the expected values below were worked out with
+struct TestRotationalGains
+{
+    static constexpr float KP = 0.75;
+    static constexpr float KI = 0.0;
+    static constexpr float KD = 0.0;
+};
+typedef PID<HeadingToGoalError, TestRotationalGains, ConditionalIntegration, MaxVelocityClamp> TestRotationalController;
+
+struct IntegralGains
+{
+    static constexpr float KP = 0.0;
+    static constexpr float KI = 1.0;
+    static constexpr float KD = 0.0;
+};
+
+struct DerivativeGains
+{
+    static constexpr float KP = 0.0;
+    static constexpr float KI = 0.0;
+    static constexpr float KD = 1.0;
+};
+
 float const FLOAT_COMP_THRESHOLD = 0.001;
 bool runTests();
 bool assertFloatEquals(float actual, float expected);
@@ -23,25 +45,26 @@ bool assertFloatEquals(float actual, float expected) {
         std::cout << "\nACTUAL: ";
         std::cout << actual;
         std::cout << "\n";
+        return false;
     }
 }
 
 int main(int argc, char **argv) {
-    runTests();
+    bool passed = runTests();
     std::cout << tests_passed;
     std::cout << "/";
     std::cout << tests_total;
     std::cout << " Tests passed\n";
-    return 0;
+    return passed ? 0 : 1;
 }
 bool testRotationalController(std::string label, pose current_pos, pose goal_pos, float expected)
 {
-    RotationalController rotational_controller;
+    TestRotationalController rotational_controller;
     tests_total++;
     std::cout << "\nBeginning Test: ";
     std::cout << label;
 
-    float angular_velocity = rotational_controller.calculateVelocity(current_pos,goal_pos);
+    float angular_velocity = rotational_controller.step(current_pos,goal_pos);
     if (!assertFloatEquals(angular_velocity,expected))
     {
         std::cout << "\n";
@@ -56,6 +79,79 @@ bool testRotationalController(std::string label, pose current_pos, pose goal_pos
     return true;
 }
 
+bool reportResult(std::string label, float actual, float expected)
+{
+    tests_total++;
+    std::cout << "\nBeginning Test: ";
+    std::cout << label;
+
+    if (!assertFloatEquals(actual,expected))
+    {
+        std::cout << "\n";
+        std::cout << label;
+        std::cout << " FAILED\n";
+        return false;
+    }
+    std::cout << "\n";
+    std::cout << label;
+    std::cout << " PASSED\n";
+    tests_passed++;
+    return true;
+}
+
+// Constant error of 0.5 rad for steps of dt seconds: the integral must be 0.5 * total time, whatever the step
+bool testIntegralUsesDt(std::string label, float dt, int steps)
+{
+    PID<GoalThetaError, IntegralGains, NoAntiWindup, NoClamp> controller;
+    pose current_pos = {0, 0, 0};
+    pose goal_pos = {0, 0, 0.5};
+
+    float output = 0;
+    for (int i = 0; i < steps; i++) output = controller.step(current_pos, goal_pos, dt);
+    return reportResult(label, output, 0.5*dt*steps);
+}
+
+// The error falls from 1 to 0.5 rad in 0.5 s, so the derivative is -1 rad/s
+bool testDerivativeSign(std::string label)
+{
+    PID<GoalThetaError, DerivativeGains, NoAntiWindup, NoClamp> controller;
+    pose goal_pos = {0, 0, 1};
+    pose first_pos = {0, 0, 0};
+    pose second_pos = {0, 0, 0.5};
+
+    controller.step(first_pos, goal_pos, 0.5);
+    return reportResult(label, controller.step(second_pos, goal_pos, 0.5), -1.0);
+}
+
+// A saturated output must not keep winding the integrator up. It stops at 0.25, the last value below the clamp.
+bool testAntiWindup(std::string label)
+{
+    PID<GoalThetaError, IntegralGains, ConditionalIntegration, MaxVelocityClamp> controller;
+    pose current_pos = {0, 0, 0};
+    pose goal_pos = {0, 0, 1};
+
+    float output = 0;
+    for (int i = 0; i < 10; i++) output = controller.step(current_pos, goal_pos, 0.25);
+    return reportResult(label + " output", output, 0.3) && reportResult(label + " integrator", controller.getIntegrator(), 0.25);
+}
+
+bool testGoalChangeResetsIntegrator(std::string label)
+{
+    PID<DistanceToGoalError, IntegralGains, NoAntiWindup, NoClamp> controller;
+    pose current_pos = {0, 0, 0};
+    pose first_goal = {1, 0, 0};
+    pose second_goal = {0, 2, 0};
+
+    for (int i = 0; i < 5; i++) controller.step(current_pos, first_goal, 0.1);
+    return reportResult(label, controller.step(current_pos, second_goal, 0.1), 0.2);
+}
+
+bool testGoalReached(std::string label, pose current_pos, pose goal_pos, bool expected)
+{
+    TranslationalController controller;
+    return reportResult(label, controller.isGoalReached(current_pos, goal_pos) ? 1 : 0, expected ? 1 : 0);
+}
+
 bool runTests()
 {
 //    testRotationalController("Test1",{0.0,0.0,0},{0,1,1.5708},0.3);
@@ -209,4 +305,13 @@ bool runTests()
 //    testRotationalController("Test149",{0.0,0.0,1.5707},{0,1,1.5708},6.1306e-05);
 //    testRotationalController("Test150",{0.0,0.0,1.5707},{0,1,1.5708},5.6708e-05);
 
+    testIntegralUsesDt("IntegralAt10Hz", 0.1, 20);
+    testIntegralUsesDt("IntegralAt50Hz", 0.02, 100);
+    testDerivativeSign("DerivativeSign");
+    testAntiWindup("AntiWindup");
+    testGoalChangeResetsIntegrator("GoalChangeResetsIntegrator");
+    testGoalReached("GoalReachedInside", {0.0,0.0,0}, {0.3,0.3,0}, true);
+    testGoalReached("GoalReachedOutside", {0.0,0.0,0}, {0.4,0.4,0}, false);
+
+    return tests_passed == tests_total;
 }
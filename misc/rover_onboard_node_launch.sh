@@ -20,6 +20,16 @@ else
 fi
 
 
+#Place of this rover in the swarm: an index unique to each rover, from 0 to the swarm size - 1
+if [ -z "$2" ] || [ -z "$3" ]
+then
+    echo "Error: usage: $0 <ROS_MASTER_URI hostname> <swarm index> <swarm size>"
+    exit 1
+fi
+swarmIndex=$2
+swarmSize=$3
+
+
 #Set prefix to fully qualify transforms for each robot
 rosparam set tf_prefix $HOSTNAME
 
@@ -44,7 +54,7 @@ findDevicePath() {
 
 #Startup ROS packages/processes
 nohup rosrun target_detection camera &
-nohup rosrun mobility mobility &
+nohup rosrun mobility mobility _swarm_index:=$swarmIndex _swarm_size:=$swarmSize &
 nohup rosrun obstacle_detection obstacle &
 nohup rosrun target_detection target &
 
@@ -0,0 +1,288 @@
+#include <sdf/sdf.hh>
+#include "gazebo/gazebo.hh"
+#include "gazebo/common/Plugin.hh"
+#include "gazebo/physics/physics.hh"
+#include <ros/ros.h>
+#include <ros/callback_queue.h>
+#include <sensor_msgs/Image.h>
+#include <std_msgs/Int16.h>
+#include <shared_messages/TrialScore.h>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "TagModels.h"
+
+using namespace std;
+
+namespace gazebo
+{
+  // Scores the foraging task from the simulated target positions instead of from camera images.
+  //
+  // Rovers still publish an image on /<rover>/targetPickUpImage and /<rover>/targetDropOffImage, but the image is
+  // only used as the request. A pick up gets the nearest tag within pickup_radius of the rover's gripper that nobody
+  // is carrying or has collected. A drop off counts if the gripper is within collection_radius of the collection
+  // disk. Replies go out on the same latched topics the GUI uses, so the rovers cannot tell the difference.
+  //
+  // The score is published as a shared_messages/TrialScore on /score at a fixed simulated rate.
+  //
+  // Only load this plugin in worlds that are run without the GUI, since the GUI answers the same requests.
+  //
+  // Optional SDF parameters:
+  //   <gripper_offset>     distance of the gripper ahead of the rover origin in meters (default 0.2)
+  //   <pickup_radius>      meters (default 0.15)
+  //   <collection_radius>  meters from the center of the collection disk (default 0.5)
+  //   <publish_rate>       score messages per simulated second (default 1)
+  class ScoringPlugin : public WorldPlugin
+  {
+    private: struct Tag
+    {
+      int id;
+      physics::ModelPtr model;
+      double offset_x, offset_y; // From the model origin, in the model frame
+    };
+
+    private: struct Rover
+    {
+      physics::ModelPtr model;
+      ros::Publisher pick_up_publisher;
+      ros::Publisher drop_off_publisher;
+      ros::Subscriber pick_up_subscriber;
+      ros::Subscriber drop_off_subscriber;
+      int carried_id; // -1 if the rover is not carrying a target
+    };
+
+    public: ~ScoringPlugin()
+    {
+      if (update_connection) event::Events::DisconnectWorldUpdateBegin(update_connection);
+      if (node_handle) node_handle->shutdown();
+    }
+
+    public: void Load(physics::WorldPtr _parent, sdf::ElementPtr _sdf)
+    {
+      if (!ros::isInitialized())
+      {
+        cerr << "ScoringPlugin: ROS is not initialized, load gazebo with libgazebo_ros_api_plugin.so" << endl;
+        return;
+      }
+
+      world = _parent;
+
+      gripper_offset = 0.2;
+      pickup_radius = 0.15;
+      collection_radius = 0.5;
+      double publish_rate = 1;
+      if (_sdf->HasElement("gripper_offset")) gripper_offset = _sdf->Get<double>("gripper_offset");
+      if (_sdf->HasElement("pickup_radius")) pickup_radius = _sdf->Get<double>("pickup_radius");
+      if (_sdf->HasElement("collection_radius")) collection_radius = _sdf->Get<double>("collection_radius");
+      if (_sdf->HasElement("publish_rate")) publish_rate = _sdf->Get<double>("publish_rate");
+      publish_period = common::Time(1.0 / publish_rate);
+
+      // Requests are queued here and handled in the world update, where the model poses are consistent
+      node_handle.reset(new ros::NodeHandle());
+      node_handle->setCallbackQueue(&callback_queue);
+      score_publisher = node_handle->advertise<shared_messages::TrialScore>("/score", 10, true);
+
+      failed_drop_offs = 0;
+      known_model_count = 0;
+      last_publish = world->GetSimTime();
+
+      update_connection = event::Events::ConnectWorldUpdateBegin(boost::bind(&ScoringPlugin::OnUpdate, this, _1));
+
+      cout << "Scoring plugin loaded." << endl;
+    }
+
+    private: void OnUpdate(const common::UpdateInfo& _info)
+    {
+      // Targets and rovers can be spawned after the world is loaded
+      if (world->GetModelCount() != known_model_count) refreshModels();
+
+      callback_queue.callAvailable();
+
+      if (_info.simTime - last_publish >= publish_period)
+      {
+        last_publish = _info.simTime;
+        publishScore();
+      }
+    }
+
+    // Rebuilds the tag table and adds any new rovers. Collected and carried tags are kept by ID.
+    private: void refreshModels()
+    {
+      physics::Model_V models = world->GetModels();
+      known_model_count = models.size();
+
+      tags.clear();
+      collection_disk.reset();
+      for (map<string, Rover>::iterator it = rovers.begin(); it != rovers.end(); ++it) it->second.model.reset();
+
+      for (unsigned int i = 0; i < models.size(); i++)
+      {
+        string name = models[i]->GetName();
+
+        TagModel tag_model;
+        if (parseTagModel(name, tag_model))
+        {
+          for (int j = 0; j < tag_model.count(); j++)
+          {
+            Tag tag = { tag_model.first_id + j, models[i], tag_model.offsetX(j), tag_model.offsetY(j) };
+            tags.push_back(tag);
+          }
+        }
+        else if (name == "collection_disk")
+        {
+          collection_disk = models[i];
+        }
+        else if (models[i]->GetSensorCount() > 0) // Rovers are the only models that carry sensors
+        {
+          addRover(name, models[i]);
+        }
+      }
+    }
+
+    private: void addRover(const string& name, physics::ModelPtr model)
+    {
+      map<string, Rover>::iterator existing = rovers.find(name);
+      if (existing != rovers.end())
+      {
+        existing->second.model = model;
+        return;
+      }
+
+      Rover& rover = rovers[name];
+      rover.model = model;
+      rover.carried_id = -1;
+      rover.pick_up_publisher = node_handle->advertise<std_msgs::Int16>("/"+name+"/targetPickUpValue", 10, true);
+      rover.drop_off_publisher = node_handle->advertise<std_msgs::Int16>("/"+name+"/targetDropOffValue", 10, true);
+      rover.pick_up_subscriber = node_handle->subscribe<sensor_msgs::Image>("/"+name+"/targetPickUpImage", 10,
+                                                                           boost::bind(&ScoringPlugin::pickUpHandler, this, name, _1));
+      rover.drop_off_subscriber = node_handle->subscribe<sensor_msgs::Image>("/"+name+"/targetDropOffImage", 10,
+                                                                            boost::bind(&ScoringPlugin::dropOffHandler, this, name, _1));
+    }
+
+    private: void pickUpHandler(const string& rover_name, const sensor_msgs::ImageConstPtr&)
+    {
+      Rover& rover = rovers[rover_name];
+      if (!rover.model) return;
+
+      math::Vector3 gripper = gripperPosition(rover.model);
+
+      int nearest = -1;
+      double nearest_distance_squared = pickup_radius * pickup_radius;
+      for (size_t i = 0; i < tags.size(); i++)
+      {
+        if (collected.count(tags[i].id) > 0 || isCarried(tags[i].id)) continue;
+
+        math::Pose pose = tags[i].model->GetWorldPose();
+        math::Vector3 position = pose.pos + pose.rot.RotateVector(math::Vector3(tags[i].offset_x, tags[i].offset_y, 0));
+
+        double dx = position.x - gripper.x;
+        double dy = position.y - gripper.y;
+        double distance_squared = dx*dx + dy*dy;
+        if (distance_squared <= nearest_distance_squared)
+        {
+          nearest = i;
+          nearest_distance_squared = distance_squared;
+        }
+      }
+
+      std_msgs::Int16 reply;
+      reply.data = -1;
+      if (nearest >= 0)
+      {
+        rover.carried_id = tags[nearest].id;
+        reply.data = rover.carried_id;
+      }
+      rover.pick_up_publisher.publish(reply);
+    }
+
+    private: void dropOffHandler(const string& rover_name, const sensor_msgs::ImageConstPtr&)
+    {
+      Rover& rover = rovers[rover_name];
+      if (!rover.model) return;
+
+      math::Vector3 zone = collection_disk ? collection_disk->GetWorldPose().pos : math::Vector3::Zero;
+      math::Vector3 gripper = gripperPosition(rover.model);
+      double dx = gripper.x - zone.x;
+      double dy = gripper.y - zone.y;
+
+      // Same as an image that does not show the collection zone: no reply
+      if (dx*dx + dy*dy > collection_radius * collection_radius) return;
+
+      std_msgs::Int16 reply;
+      if (rover.carried_id < 0)
+      {
+        failed_drop_offs++;
+        reply.data = -1;
+      }
+      else
+      {
+        collected.insert(rover.carried_id);
+        collected_ids.push_back(rover.carried_id);
+        rover.carried_id = -1;
+        reply.data = COLLECTION_ZONE_ID;
+      }
+      rover.drop_off_publisher.publish(reply);
+    }
+
+    private: void publishScore()
+    {
+      shared_messages::TrialScore score;
+      score.header.stamp = ros::Time(last_publish.sec, last_publish.nsec);
+      score.targets_collected = collected_ids.size();
+      score.targets_carried = 0;
+      for (map<string, Rover>::iterator it = rovers.begin(); it != rovers.end(); ++it)
+      {
+        if (it->second.carried_id >= 0) score.targets_carried++;
+      }
+      score.failed_drop_offs = failed_drop_offs;
+      score.collected_ids = collected_ids;
+
+      score_publisher.publish(score);
+    }
+
+    private: math::Vector3 gripperPosition(physics::ModelPtr rover) const
+    {
+      math::Pose pose = rover->GetWorldPose();
+      return pose.pos + pose.rot.RotateVector(math::Vector3(gripper_offset, 0, 0));
+    }
+
+    private: bool isCarried(int id) const
+    {
+      for (map<string, Rover>::const_iterator it = rovers.begin(); it != rovers.end(); ++it)
+      {
+        if (it->second.carried_id == id) return true;
+      }
+      return false;
+    }
+
+    private: physics::WorldPtr world;
+    private: event::ConnectionPtr update_connection;
+
+    private: boost::shared_ptr<ros::NodeHandle> node_handle; // Created in Load, once ROS is known to be running
+    private: ros::CallbackQueue callback_queue;
+    private: ros::Publisher score_publisher;
+
+    private: double gripper_offset;
+    private: double pickup_radius;
+    private: double collection_radius;
+    private: common::Time publish_period;
+    private: common::Time last_publish;
+
+    private: unsigned int known_model_count;
+    private: vector<Tag> tags;
+    private: physics::ModelPtr collection_disk;
+    private: map<string, Rover> rovers;
+
+    private: set<int> collected;
+    private: vector<int16_t> collected_ids;
+    private: unsigned long failed_drop_offs;
+  };
+
+  // Register this plugin with the simulator
+  GZ_REGISTER_WORLD_PLUGIN(ScoringPlugin)
+}
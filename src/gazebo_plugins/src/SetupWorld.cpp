@@ -5,17 +5,59 @@
 #include "gazebo/physics/physics.hh"
 #include "gazebo/transport/transport.hh"
 #include <iostream>
+#include <string>
 
 using namespace std;
 
 namespace gazebo
 {
+  // Configures the physics engine for the swarmathon world.
+  //
+  // Optional SDF parameters:
+  //   <profile>               "default" or "fast". Sets the values below, which can still be overridden one by one.
+  //   <max_step_size>         physics step in seconds (default 0.01)
+  //   <real_time_update_rate> physics steps per wall clock second, 0 runs as fast as possible
+  //                           (default: left as gazebo has it)
+  //   <real_time_factor>      target simulated seconds per wall clock second. Converted to an update rate.
+  //   <iters>                 ODE solver iterations per step (default: left as gazebo has it)
+  //   <sor>                   ODE successive over-relaxation parameter (default: left as gazebo has it)
+  //   <max_contacts>          contact points per rover collision, 0 leaves gazebo's value
+  //
+  // The fast profile is for headless batch trials. It only changes the update rate (unthrottled), the solver
+  // iterations and the contact points per rover collision (at most four).
   class SetupWorld : public WorldPlugin
   {
     public: void Load(physics::WorldPtr _parent, sdf::ElementPtr _sdf)
     {
       cout << "Setting up world..." << flush;
 
+      double max_step_size = 0.01;
+      double real_time_update_rate = -1; // negative leaves the value alone
+      int iters = -1;
+      double sor = -1;
+      int max_contacts = 0;
+
+      string profile = "default";
+      if (_sdf->HasElement("profile")) profile = _sdf->Get<string>("profile");
+
+      if (profile == "fast")
+      {
+        real_time_update_rate = 0;
+        iters = 20;
+        max_contacts = 4;
+      }
+      else if (profile != "default")
+      {
+        cout << " unknown profile " << profile << ", using default..." << flush;
+      }
+
+      if (_sdf->HasElement("max_step_size")) max_step_size = _sdf->Get<double>("max_step_size");
+      if (_sdf->HasElement("real_time_update_rate")) real_time_update_rate = _sdf->Get<double>("real_time_update_rate");
+      if (_sdf->HasElement("real_time_factor")) real_time_update_rate = _sdf->Get<double>("real_time_factor") / max_step_size;
+      if (_sdf->HasElement("iters")) iters = _sdf->Get<int>("iters");
+      if (_sdf->HasElement("sor")) sor = _sdf->Get<double>("sor");
+      if (_sdf->HasElement("max_contacts")) max_contacts = _sdf->Get<int>("max_contacts");
+
       // Create a new transport node
       transport::NodePtr node(new transport::Node());
 
@@ -30,14 +72,39 @@ namespace gazebo
       physicsMsg.set_type(msgs::Physics::ODE);
 
       // Set the step time
-      physicsMsg.set_max_step_size(0.01);
+      physicsMsg.set_max_step_size(max_step_size);
+
+      if (real_time_update_rate >= 0) physicsMsg.set_real_time_update_rate(real_time_update_rate);
+      if (iters > 0) physicsMsg.set_iters(iters);
+      if (sor > 0) physicsMsg.set_sor(sor);
 
       // Change gravity
       //msgs::Set(physicsMsg.mutable_gravity(), math::Vector3(0.01, 0, 0.1));
-      
+
       physicsPub->Publish(physicsMsg);
 
-      cout << " done." << endl;
+      // Models in the world file are loaded before world plugins, so the rovers are adjusted here
+      physics::Model_V models = _parent->GetModels();
+      for (unsigned int i = 0; i < models.size(); i++)
+      {
+        if (max_contacts > 0 && isRover(models[i]))
+        {
+          physics::Link_V links = models[i]->GetLinks();
+          for (unsigned int j = 0; j < links.size(); j++)
+          {
+            physics::Collision_V collisions = links[j]->GetCollisions();
+            for (unsigned int k = 0; k < collisions.size(); k++) collisions[k]->SetMaxContacts(max_contacts);
+          }
+        }
+      }
+
+      cout << " done (" << profile << " profile, step " << max_step_size << " s)." << endl;
+    }
+
+    // Rovers are the only models that carry sensors
+    private: static bool isRover(physics::ModelPtr model)
+    {
+      return model->GetSensorCount() > 0;
     }
   };
 
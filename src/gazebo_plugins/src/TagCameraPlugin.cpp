@@ -0,0 +1,332 @@
+#include <sdf/sdf.hh>
+#include "gazebo/gazebo.hh"
+#include "gazebo/common/Plugin.hh"
+#include "gazebo/physics/physics.hh"
+#include "gazebo/sensors/sensors.hh"
+#include <ros/ros.h>
+#include <shared_messages/TagsImage.h>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TagModels.h"
+
+using namespace std;
+
+namespace gazebo
+{
+  // Stands in for the rover cameras and the target_detection nodes in large simulations.
+  //
+  // For every rover with a camera sensor, at the camera's update rate, works out which tags are inside the camera's
+  // view, facing it, large enough in the image to be decoded and not hidden behind another model. The result is
+  // published on /<rover>/targets as a shared_messages/TagsImage, as target_detection does, with a TagDetection
+  // (corners in the detector's 320x240 image and pose in the camera frame) for each tag. The image is left empty.
+  //
+  // The camera sensors are switched off, so nothing is rendered. Since the rovers then publish empty images when
+  // they pick up or drop off, load this plugin together with the ScoringPlugin, never with the GUI.
+  //
+  // Optional SDF parameters:
+  //   <min_tag_pixels>   smallest tag the detector decodes, as the square root of its area in pixels (default 12)
+  //   <corner_noise>     standard deviation of the corner positions in pixels (default 0.5)
+  //   <position_noise>   standard deviation of the pose position per meter of distance (default 0.01)
+  //   <seed>             noise seed (default 0)
+  //   <disable_cameras>  switch the camera sensors off (default true)
+  class TagCameraPlugin : public WorldPlugin
+  {
+    private: struct Tag
+    {
+      int id;
+      physics::ModelPtr model;
+      double offset_x, offset_y; // From the model origin, in the model frame
+    };
+
+    private: struct RoverCamera
+    {
+      string rover_name;
+      physics::LinkPtr link;
+      math::Pose pose;        // Relative to link
+      double focal_length;    // Pixels of the detection image
+      common::Time period;
+      common::Time next_update;
+      string sensor_name;     // Scoped name, for switching the sensor off
+      bool sensor_disabled;
+      ros::Publisher publisher;
+    };
+
+    public: ~TagCameraPlugin()
+    {
+      if (update_connection) event::Events::DisconnectWorldUpdateBegin(update_connection);
+      if (node_handle) node_handle->shutdown();
+    }
+
+    public: void Load(physics::WorldPtr _parent, sdf::ElementPtr _sdf)
+    {
+      if (!ros::isInitialized())
+      {
+        cerr << "TagCameraPlugin: ROS is not initialized, load gazebo with libgazebo_ros_api_plugin.so" << endl;
+        return;
+      }
+
+      world = _parent;
+
+      min_tag_pixels = 12;
+      corner_noise = 0.5;
+      position_noise = 0.01;
+      unsigned int seed = 0;
+      disable_cameras = true;
+      if (_sdf->HasElement("min_tag_pixels")) min_tag_pixels = _sdf->Get<double>("min_tag_pixels");
+      if (_sdf->HasElement("corner_noise")) corner_noise = _sdf->Get<double>("corner_noise");
+      if (_sdf->HasElement("position_noise")) position_noise = _sdf->Get<double>("position_noise");
+      if (_sdf->HasElement("seed")) seed = _sdf->Get<unsigned int>("seed");
+      if (_sdf->HasElement("disable_cameras")) disable_cameras = _sdf->Get<bool>("disable_cameras");
+      noise_engine.seed(seed);
+
+      node_handle.reset(new ros::NodeHandle());
+
+      // Occlusion test, the same way the world finds the entity below a point
+      occlusion_ray = boost::dynamic_pointer_cast<physics::RayShape>(world->GetPhysicsEngine()->CreateShape("ray", physics::CollisionPtr()));
+
+      known_model_count = 0;
+
+      update_connection = event::Events::ConnectWorldUpdateBegin(boost::bind(&TagCameraPlugin::OnUpdate, this, _1));
+
+      cout << "Tag camera plugin loaded." << endl;
+    }
+
+    private: void OnUpdate(const common::UpdateInfo& _info)
+    {
+      // Targets and rovers can be spawned after the world is loaded
+      if (world->GetModelCount() != known_model_count) refreshModels();
+
+      for (size_t i = 0; i < cameras.size(); i++)
+      {
+        RoverCamera& camera = cameras[i];
+
+        // Sensors are created after the plugins are loaded, so keep trying until the camera exists
+        if (disable_cameras && !camera.sensor_disabled)
+        {
+          sensors::SensorPtr sensor = sensors::get_sensor(camera.sensor_name);
+          if (sensor)
+          {
+            sensor->SetActive(false);
+            camera.sensor_disabled = true;
+          }
+        }
+
+        if (_info.simTime < camera.next_update) continue;
+        camera.next_update = _info.simTime + camera.period;
+
+        detect(camera);
+      }
+    }
+
+    // Rebuilds the tag table and the camera list
+    private: void refreshModels()
+    {
+      physics::Model_V models = world->GetModels();
+      known_model_count = models.size();
+
+      tags.clear();
+      vector<RoverCamera> previous_cameras;
+      previous_cameras.swap(cameras);
+
+      for (unsigned int i = 0; i < models.size(); i++)
+      {
+        TagModel tag_model;
+        if (parseTagModel(models[i]->GetName(), tag_model))
+        {
+          for (int j = 0; j < tag_model.count(); j++)
+          {
+            Tag tag = { tag_model.first_id + j, models[i], tag_model.offsetX(j), tag_model.offsetY(j) };
+            tags.push_back(tag);
+          }
+        }
+        else if (models[i]->GetSensorCount() > 0) // Rovers are the only models that carry sensors
+        {
+          addCamera(models[i], previous_cameras);
+        }
+      }
+    }
+
+    // Finds the camera sensor in the rover's links. Cameras that were already known keep their publisher and state.
+    private: void addCamera(physics::ModelPtr model, const vector<RoverCamera>& previous_cameras)
+    {
+      physics::Link_V links = model->GetLinks();
+      for (unsigned int i = 0; i < links.size(); i++)
+      {
+        sdf::ElementPtr link_sdf = links[i]->GetSDF();
+        if (!link_sdf->HasElement("sensor")) continue;
+
+        for (sdf::ElementPtr sensor = link_sdf->GetElement("sensor"); sensor; sensor = sensor->GetNextElement("sensor"))
+        {
+          if (sensor->Get<string>("type") != "camera") continue;
+
+          RoverCamera camera;
+          camera.sensor_name = world->GetName() + "::" + links[i]->GetScopedName() + "::" + sensor->Get<string>("name");
+          camera.rover_name = model->GetName();
+          camera.link = links[i];
+
+          bool known = false;
+          for (size_t j = 0; j < previous_cameras.size(); j++)
+          {
+            if (previous_cameras[j].sensor_name == camera.sensor_name)
+            {
+              camera = previous_cameras[j];
+              camera.link = links[i];
+              known = true;
+            }
+          }
+
+          if (!known)
+          {
+            sdf::Pose pose = sensor->Get<sdf::Pose>("pose");
+            camera.pose = math::Pose(math::Vector3(pose.pos.x, pose.pos.y, pose.pos.z),
+                                     math::Quaternion(pose.rot.w, pose.rot.x, pose.rot.y, pose.rot.z));
+
+            double horizontal_fov = sensor->GetElement("camera")->Get<double>("horizontal_fov");
+            camera.focal_length = (IMAGE_WIDTH / 2.0) / tan(horizontal_fov / 2);
+
+            double update_rate = sensor->Get<double>("update_rate");
+            camera.period = common::Time(update_rate > 0 ? 1.0 / update_rate : 0.0);
+            camera.next_update = world->GetSimTime();
+            camera.sensor_disabled = false;
+            camera.publisher = node_handle->advertise<shared_messages::TagsImage>("/" + camera.rover_name + "/targets", 2, true);
+          }
+
+          cameras.push_back(camera);
+          return;
+        }
+      }
+    }
+
+    private: void detect(RoverCamera& camera)
+    {
+      math::Pose camera_pose = camera.pose + camera.link->GetWorldPose();
+
+      // Beyond this distance even a tag facing the camera is smaller than min_tag_pixels
+      double max_range = TAG_WIDTH * camera.focal_length / min_tag_pixels;
+
+      shared_messages::TagsImage message;
+      for (size_t i = 0; i < tags.size(); i++)
+      {
+        math::Pose tag_pose = tags[i].model->GetWorldPose();
+        math::Vector3 center = tag_pose.pos + tag_pose.rot.RotateVector(math::Vector3(tags[i].offset_x, tags[i].offset_y, 0));
+        math::Vector3 to_camera = camera_pose.pos - center;
+
+        if (to_camera.GetLength() > max_range) continue;
+
+        // The tag texture is on the top face
+        if (tag_pose.rot.RotateVector(math::Vector3::UnitZ).Dot(to_camera) <= 0) continue;
+
+        shared_messages::TagDetection detection;
+        if (!project(camera, camera_pose, tags[i], tag_pose, center, detection)) continue;
+        if (occluded(camera, camera_pose.pos, center, tags[i].model->GetName())) continue;
+
+        detection.id = tags[i].id;
+        message.tags.data.push_back(tags[i].id);
+        message.detections.push_back(detection);
+      }
+
+      if (!message.detections.empty()) camera.publisher.publish(message);
+    }
+
+    // Fills in the corners and pose. Returns false unless the whole tag is in the image and large enough to decode.
+    private: bool project(const RoverCamera& camera, const math::Pose& camera_pose, const Tag& tag, const math::Pose& tag_pose,
+                          const math::Vector3& center, shared_messages::TagDetection& detection)
+    {
+      static const double CORNER_X[4] = { -0.5, 0.5, 0.5, -0.5 };
+      static const double CORNER_Y[4] = { -0.5, -0.5, 0.5, 0.5 };
+
+      normal_distribution<double> pixel_noise(0, corner_noise);
+
+      double area = 0;
+      double u[4], v[4];
+      for (int i = 0; i < 4; i++)
+      {
+        math::Vector3 corner = tag_pose.pos + tag_pose.rot.RotateVector(math::Vector3(tag.offset_x + CORNER_X[i]*TAG_WIDTH,
+                                                                                      tag.offset_y + CORNER_Y[i]*TAG_HEIGHT, 0));
+        math::Vector3 in_camera = camera_pose.rot.RotateVectorReverse(corner - camera_pose.pos);
+        if (in_camera.x <= 0) return false;
+
+        // Gazebo cameras look along +x with +y to the left and +z up
+        u[i] = IMAGE_WIDTH/2.0 - camera.focal_length * in_camera.y / in_camera.x;
+        v[i] = IMAGE_HEIGHT/2.0 - camera.focal_length * in_camera.z / in_camera.x;
+        if (u[i] < 0 || u[i] >= IMAGE_WIDTH || v[i] < 0 || v[i] >= IMAGE_HEIGHT) return false;
+
+        if (corner_noise > 0)
+        {
+          u[i] += pixel_noise(noise_engine);
+          v[i] += pixel_noise(noise_engine);
+        }
+        detection.corners[2*i] = u[i];
+        detection.corners[2*i + 1] = v[i];
+      }
+
+      for (int i = 0; i < 4; i++) area += u[i]*v[(i+1)%4] - u[(i+1)%4]*v[i];
+      if (sqrt(fabs(area) / 2) < min_tag_pixels) return false;
+
+      math::Vector3 position = camera_pose.rot.RotateVectorReverse(center - camera_pose.pos);
+      if (position_noise > 0)
+      {
+        normal_distribution<double> distance_noise(0, position_noise * position.GetLength());
+        position += math::Vector3(distance_noise(noise_engine), distance_noise(noise_engine), distance_noise(noise_engine));
+      }
+      math::Quaternion orientation = camera_pose.rot.GetInverse() * tag_pose.rot;
+
+      detection.pose.position.x = position.x;
+      detection.pose.position.y = position.y;
+      detection.pose.position.z = position.z;
+      detection.pose.orientation.w = orientation.w;
+      detection.pose.orientation.x = orientation.x;
+      detection.pose.orientation.y = orientation.y;
+      detection.pose.orientation.z = orientation.z;
+
+      return true;
+    }
+
+    // True if a model other than the tag's own or the observing rover is between the camera and the tag
+    private: bool occluded(const RoverCamera& camera, const math::Vector3& from, const math::Vector3& center, const string& tag_model)
+    {
+      // Aim just above the tag so the ray does not end inside its box or the ground
+      math::Vector3 to = center + math::Vector3(0, 0, 0.005);
+      occlusion_ray->SetPoints(from, to);
+
+      double distance;
+      string entity;
+      occlusion_ray->GetIntersection(distance, entity);
+
+      if (entity.empty() || distance >= from.Distance(to) - 0.01) return false;
+      if (entity.compare(0, tag_model.size() + 2, tag_model + "::") == 0) return false;
+      if (entity.compare(0, camera.rover_name.size() + 2, camera.rover_name + "::") == 0) return false;
+
+      return true;
+    }
+
+    // Size of the image target_detection works on
+    private: static const int IMAGE_WIDTH = 320;
+    private: static const int IMAGE_HEIGHT = 240;
+
+    private: physics::WorldPtr world;
+    private: event::ConnectionPtr update_connection;
+    private: physics::RayShapePtr occlusion_ray;
+
+    private: boost::shared_ptr<ros::NodeHandle> node_handle; // Created in Load, once ROS is known to be running
+
+    private: double min_tag_pixels;
+    private: double corner_noise;
+    private: double position_noise;
+    private: bool disable_cameras;
+    private: mt19937 noise_engine;
+
+    private: unsigned int known_model_count;
+    private: vector<Tag> tags;
+    private: vector<RoverCamera> cameras;
+  };
+
+  // Register this plugin with the simulator
+  GZ_REGISTER_WORLD_PLUGIN(TagCameraPlugin)
+}
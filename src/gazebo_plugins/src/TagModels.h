@@ -0,0 +1,69 @@
+#ifndef TAG_MODELS_H
+#define TAG_MODELS_H
+
+#include <cctype>
+#include <cstdlib>
+#include <string>
+
+namespace gazebo
+{
+  // Size of one AprilTag target's collision box in meters
+  const double TAG_WIDTH = 0.0763;
+  const double TAG_HEIGHT = 0.05912;
+
+  // The tag printed on the collection disk
+  const int COLLECTION_ZONE_ID = 256;
+
+  // The tags carried by a target model. Single targets are "at<N>" and carry tag N. Piles are "atags<size>_<k>",
+  // a grid_size x grid_size block of tags on one textured box, numbered row by row from the model's +x,+y corner:
+  //   atags64_k  tags 64k ... 64k+63
+  //   atags16_k  tags 64+16k ... 64+16k+15
+  //   atags4_k   tags 128+4k ... 128+4k+3
+  //   atags256   tags 0 ... 255
+  // These are the IDs the layouts in sim_layout assume, so no two models of one layout share a tag.
+  struct TagModel
+  {
+    int first_id;
+    int grid_size;
+
+    int count() const { return grid_size * grid_size; }
+
+    // Offset of tag i (0 <= i < count()) from the model origin, in the model frame
+    double offsetX(int i) const { return ((grid_size - 1) / 2.0 - i / grid_size) * TAG_WIDTH; }
+    double offsetY(int i) const { return ((grid_size - 1) / 2.0 - i % grid_size) * TAG_HEIGHT; }
+  };
+
+  // Returns false if name is not a target model
+  inline bool parseTagModel(const std::string& name, TagModel& model)
+  {
+    if (name.size() > 2 && name.compare(0, 2, "at") == 0 && isdigit(name[2]))
+    {
+      model.first_id = atoi(name.c_str() + 2);
+      model.grid_size = 1;
+      return true;
+    }
+
+    if (name == "atags256")
+    {
+      model.first_id = 0;
+      model.grid_size = 16;
+      return true;
+    }
+
+    size_t separator = name.find('_');
+    if (name.compare(0, 5, "atags") != 0 || separator == std::string::npos || separator + 1 >= name.size()) return false;
+
+    int size = atoi(name.c_str() + 5);
+    int k = atoi(name.c_str() + separator + 1);
+    switch (size)
+    {
+    case 64: model.first_id = 64*k; model.grid_size = 8; return true;
+    case 16: model.first_id = 64 + 16*k; model.grid_size = 4; return true;
+    case 4: model.first_id = 128 + 4*k; model.grid_size = 2; return true;
+    }
+
+    return false;
+  }
+}
+
+#endif // TAG_MODELS_H
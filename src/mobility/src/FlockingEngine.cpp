@@ -0,0 +1,219 @@
+#include <cmath>
+#include "FlockingEngine.h"
+
+namespace
+{
+
+// Vectors shorter than this are treated as zero instead of being normalised
+const float MIN_NORM = 1E-6;
+
+// Scales (x, y) to length weight, or to zero if it has no direction
+void normalise(float& x, float& y, float weight)
+{
+    float norm = sqrt(x*x + y*y);
+    if (norm < MIN_NORM)
+    {
+        x = 0;
+        y = 0;
+        return;
+    }
+
+    x = x/norm * weight;
+    y = y/norm * weight;
+}
+
+}
+
+// The values the unrolled 6 rover code used
+FlockingEngine::Parameters::Parameters()
+{
+    neighbour_radius = 2.0;
+    separation_distance = 1.0;
+    separation_weight = 0.5;
+    cohesion_weight = 0.0;
+    alignment_weight = 0.0;
+    max_neighbours = 0;
+    max_pose_age = 1.0;
+}
+
+FlockingEngine::FlockingEngine()
+{
+    grid.setCellSize(parameters.neighbour_radius);
+    sum_cos = 0;
+    sum_sin = 0;
+    max_speed = 0;
+}
+
+void FlockingEngine::setParameters(const Parameters& parameters)
+{
+    this->parameters = parameters;
+    grid.setCellSize(parameters.neighbour_radius > 0 ? parameters.neighbour_radius : 1.0f);
+}
+
+const FlockingEngine::Parameters& FlockingEngine::getParameters() const
+{
+    return parameters;
+}
+
+void FlockingEngine::update(int id, float x, float y, float theta, float velocity, double stamp)
+{
+    if (id < 0) return;
+    if (id >= (int)row_of_id.size()) row_of_id.resize(id + 1, -1);
+
+    int row = row_of_id[id];
+    if (row < 0)
+    {
+        row = ids.size();
+        row_of_id[id] = row;
+        ids.push_back(id);
+        xs.push_back(0);
+        ys.push_back(0);
+        cos_thetas.push_back(0);
+        sin_thetas.push_back(0);
+        velocities.push_back(0);
+        stamps.push_back(0);
+    }
+
+    float cos_theta = cos(theta);
+    float sin_theta = sin(theta);
+    sum_cos += cos_theta - cos_thetas[row];
+    sum_sin += sin_theta - sin_thetas[row];
+
+    xs[row] = x;
+    ys[row] = y;
+    cos_thetas[row] = cos_theta;
+    sin_thetas[row] = sin_theta;
+    velocities[row] = velocity;
+    stamps[row] = stamp;
+    grid.update(row, x, y);
+
+    if (fabs(velocity) > max_speed) max_speed = fabs(velocity);
+}
+
+void FlockingEngine::expire(double now)
+{
+    // Backwards, so the row moved into a removed slot has already been checked
+    if (parameters.max_pose_age > 0)
+    {
+        double oldest = now - parameters.max_pose_age;
+        for (int row = ids.size() - 1; row >= 0; row--)
+        {
+            if (stamps[row] < oldest) removeRow(row);
+        }
+    }
+
+    max_speed = 0;
+    for (size_t row = 0; row < velocities.size(); row++)
+    {
+        if (fabs(velocities[row]) > max_speed) max_speed = fabs(velocities[row]);
+    }
+}
+
+void FlockingEngine::removeRow(int row)
+{
+    int last = ids.size() - 1;
+    sum_cos -= cos_thetas[row];
+    sum_sin -= sin_thetas[row];
+    row_of_id[ids[row]] = -1;
+    grid.remove(last);
+
+    if (row != last)
+    {
+        ids[row] = ids[last];
+        xs[row] = xs[last];
+        ys[row] = ys[last];
+        cos_thetas[row] = cos_thetas[last];
+        sin_thetas[row] = sin_thetas[last];
+        velocities[row] = velocities[last];
+        stamps[row] = stamps[last];
+        row_of_id[ids[row]] = row;
+        grid.update(row, xs[row], ys[row]);
+    }
+
+    ids.pop_back();
+    xs.pop_back();
+    ys.pop_back();
+    cos_thetas.pop_back();
+    sin_thetas.pop_back();
+    velocities.pop_back();
+    stamps.pop_back();
+}
+
+FlockingEngine::Result FlockingEngine::compute(int self_id, float x, float y, float theta, double now) const
+{
+    Result result;
+    result.global_average = atan2(sum_sin, sum_cos);
+
+    // The rover's own heading counts towards the alignment average
+    float alignment_x = cos(theta);
+    float alignment_y = sin(theta);
+    float cohesion_x = 0;
+    float cohesion_y = 0;
+    float separation_x = 0;
+    float separation_y = 0;
+    int num_neighbours = 0;
+
+    float radius_squared = parameters.neighbour_radius * parameters.neighbour_radius;
+    float separation_squared = parameters.separation_distance * parameters.separation_distance;
+
+    // The grid holds the positions as shared. Search far enough to catch rovers that have since driven into range.
+    float max_age = parameters.max_pose_age > 0 ? parameters.max_pose_age : 0;
+    float search_radius = parameters.neighbour_radius + max_speed*max_age;
+
+    if (parameters.max_neighbours > 0)
+    {
+        // One extra in case the rover's own row is among the closest
+        grid.nearest(x, y, parameters.max_neighbours + 1, neighbour_rows);
+    }
+    else grid.withinRadius(x, y, search_radius, neighbour_rows);
+
+    for (size_t k = 0; k < neighbour_rows.size(); k++)
+    {
+        if (parameters.max_neighbours > 0 && num_neighbours == parameters.max_neighbours) break;
+        int i = neighbour_rows[k];
+
+        // Dead reckon the neighbour from its stamp to now. Stamps from the future count as current.
+        float age = now - stamps[i];
+        if (age < 0) age = 0;
+        if (age > max_age) age = max_age;
+        float distance_travelled = velocities[i]*age;
+
+        float dx = xs[i] + distance_travelled*cos_thetas[i] - x;
+        float dy = ys[i] + distance_travelled*sin_thetas[i] - y;
+        float distance_squared = dx*dx + dy*dy;
+        if (distance_squared > radius_squared || ids[i] == self_id) continue;
+
+        num_neighbours++;
+        alignment_x += cos_thetas[i];
+        alignment_y += sin_thetas[i];
+        cohesion_x += dx;
+        cohesion_y += dy;
+
+        if (distance_squared <= separation_squared)
+        {
+            separation_x -= dx;
+            separation_y -= dy;
+        }
+    }
+
+    result.num_neighbours = num_neighbours;
+    result.local_average = atan2(alignment_y, alignment_x);
+    result.local_average_position = atan2(cohesion_y, cohesion_x);
+
+    normalise(alignment_x, alignment_y, parameters.alignment_weight);
+    normalise(cohesion_x, cohesion_y, parameters.cohesion_weight);
+    normalise(separation_x, separation_y, parameters.separation_weight);
+
+    // Keep the current heading when nothing pulls the rover in any direction
+    float combined_x = alignment_x + cohesion_x + separation_x;
+    float combined_y = alignment_y + cohesion_y + separation_y;
+    if (combined_x*combined_x + combined_y*combined_y < MIN_NORM*MIN_NORM) result.combined_theta = theta;
+    else result.combined_theta = atan2(combined_y, combined_x);
+
+    return result;
+}
+
+int FlockingEngine::size() const
+{
+    return ids.size();
+}
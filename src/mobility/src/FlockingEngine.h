@@ -0,0 +1,100 @@
+#ifndef FLOCKINGENGINE_H
+#define FLOCKINGENGINE_H
+
+#include <vector>
+#include <shared_math/NeighbourGrid.h>
+
+/**
+ * Flocking for a swarm of any size. The latest pose shared by every rover is
+ * kept in a struct of arrays, one contiguous array per field. The rows are
+ * also indexed by position in a shared_math::NeighbourGrid with cells of
+ * neighbour_radius, so compute() only looks at rovers in the 3x3 cells
+ * around the query point and its cost does not grow with the swarm size.
+ * Adding or moving a rover costs O(1).
+ *
+ * compute() combines three steering vectors for one rover, each normalised
+ * and then weighted:
+ *   alignment   mean heading of the rover and its neighbours
+ *   cohesion    towards the centroid of the neighbours
+ *   separation  away from neighbours closer than separation_distance
+ * A neighbour is any other rover within neighbour_radius. If max_neighbours
+ * is set, only that many of the closest ones are used.
+ *
+ * Poses arrive at different times, so compute() moves every neighbour forward
+ * from its stamp to the query time along its heading at its shared velocity.
+ * expire() drops rovers that have been silent for longer than max_pose_age,
+ * so a rover that stopped publishing no longer steers the others.
+ * update() only stores the pose; the caller decides how often to compute.
+ */
+class FlockingEngine
+{
+
+public:
+    struct Parameters
+    {
+        Parameters();
+
+        float neighbour_radius;     // meters
+        float separation_distance;  // meters
+        float separation_weight;
+        float cohesion_weight;
+        float alignment_weight;
+        int max_neighbours;         // 0 for every rover within neighbour_radius
+        float max_pose_age;         // seconds, 0 keeps poses forever and does not extrapolate
+    };
+
+    struct Result
+    {
+        float combined_theta;       // The heading to steer towards
+        float local_average;        // Mean heading of the rover and its neighbours
+        float local_average_position; // Direction of the cohesion vector
+        float global_average;       // Mean heading of every rover in the table
+        int num_neighbours;
+    };
+
+    FlockingEngine();
+
+    void setParameters(const Parameters& parameters);
+    const Parameters& getParameters() const;
+
+    // Stores the latest pose of rover id. stamp is in seconds.
+    void update(int id, float x, float y, float theta, float velocity, double stamp);
+
+    // Drops every rover whose latest pose is older than now - max_pose_age
+    void expire(double now);
+
+    // Flocking result for rover self_id at (x, y, theta) at time now, in seconds.
+    // self_id's own row in the table is ignored.
+    Result compute(int self_id, float x, float y, float theta, double now) const;
+
+    int size() const;
+
+private:
+    // Moves the last row into row and shrinks the table
+    void removeRow(int row);
+
+    Parameters parameters;
+
+    // One row per rover, in the order they were first heard from
+    std::vector<int> ids;
+    std::vector<float> xs;
+    std::vector<float> ys;
+    std::vector<float> cos_thetas; // Stored instead of theta so queries need no trigonometry
+    std::vector<float> sin_thetas;
+    std::vector<float> velocities;
+    std::vector<double> stamps;
+
+    std::vector<int> row_of_id; // -1 for ids not in the table
+
+    shared_math::NeighbourGrid grid; // Keyed by row
+    mutable std::vector<int> neighbour_rows; // Scratch space for compute(), kept to avoid allocating per query
+
+    // Running sums of the headings, kept up to date by update()
+    double sum_cos;
+    double sum_sin;
+
+    // Fastest shared velocity, refreshed by expire(). Bounds how far a neighbour can have moved off its grid cell.
+    float max_speed;
+};
+
+#endif // FLOCKINGENGINE_H
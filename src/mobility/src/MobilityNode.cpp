@@ -0,0 +1,472 @@
+#include "MobilityNode.h"
+
+// ROS libraries
+#include <angles/angles.h>
+
+// ROS messages
+#include <std_msgs/Int16.h>
+#include <std_msgs/Float32.h>
+
+// Fixed size stack math shared with the GUI
+#include <shared_math/Quat.h>
+
+// Custom messages
+#include <shared_messages/RoverHeartbeat.h>
+#include <shared_messages/MobilityDiagnostics.h>
+#include <shared_messages/MobilityTelemetry.h>
+
+#include <chrono>
+#include <sstream>
+
+using namespace std;
+
+// state machine states
+#define STATE_MACHINE_TRANSLATE 0
+
+namespace
+{
+
+float diagnostics_interval = 1;
+
+// What the string topics carry. The typed telemetry is always published.
+const int VERBOSITY_QUIET = 0;  // Telemetry only
+const int VERBOSITY_STATE = 1;  // Plus <rover>/state_machine whenever the state or mode changes
+const int VERBOSITY_DEBUG = 2;  // Plus the heading strings, every tick
+
+void fillHistogram(const TimingHistogram& histogram, shared_messages::LoopHistogram& message)
+{
+    message.count = histogram.count();
+    message.sum_us = histogram.sum();
+    message.max_us = histogram.max();
+    message.buckets.resize(TimingHistogram::NUM_BUCKETS);
+    for (int i = 0; i < TimingHistogram::NUM_BUCKETS; i++) message.buckets[i] = histogram.bucket(i);
+}
+
+}
+
+volatile sig_atomic_t MobilityNode::shutdown_requested = 0;
+
+MobilityNode::MobilityNode(const string& rover_name, int swarm_index, int swarm_size)
+    : rover_name(rover_name), swarm_index(swarm_index), swarm_size(swarm_size),
+      control_spinner(1, &control_queue), swarm_spinner(1, &swarm_queue)
+{
+    control_nh.setCallbackQueue(&control_queue);
+    swarm_nh.setCallbackQueue(&swarm_queue);
+
+    mobility_loop_time_step = 0.1;
+    status_publish_interval = 5;
+    heartbeat_interval = 1;
+    kill_switch_timeout = 10;
+
+    simulation_mode = 0;
+    current_location.x = 0;
+    current_location.y = 0;
+    current_location.theta = 0;
+    current_velocity = 0.0;
+    transitions_to_auto = 0;
+    time_stamp_transition_to_auto = 0.0;
+    state_machine_state = STATE_MACHINE_TRANSLATE;
+    linear_velocity_command = 0.0;
+    angular_velocity_command = 0.0;
+    published_state = -1;
+    published_mode = -1;
+
+    glob_average = 0.0;
+    local_average = 0.0;
+    local_average_position = 0.0;
+    combined_theta = 0.0;
+    num_neighbours = 0;
+
+    is_published_name = false;
+
+    // Our own id may only ever come from this node
+    publisher_of_id.resize(swarm_index + 1);
+    publisher_of_id[swarm_index] = ros::this_node::getName();
+
+    ros::NodeHandle private_nh("~");
+    private_nh.param("verbosity", verbosity, VERBOSITY_STATE);
+
+    FlockingEngine::Parameters flocking_parameters;
+    private_nh.param("neighbour_radius", flocking_parameters.neighbour_radius, flocking_parameters.neighbour_radius);
+    private_nh.param("separation_distance", flocking_parameters.separation_distance, flocking_parameters.separation_distance);
+    private_nh.param("separation_weight", flocking_parameters.separation_weight, flocking_parameters.separation_weight);
+    private_nh.param("cohesion_weight", flocking_parameters.cohesion_weight, flocking_parameters.cohesion_weight);
+    private_nh.param("alignment_weight", flocking_parameters.alignment_weight, flocking_parameters.alignment_weight);
+    private_nh.param("max_neighbours", flocking_parameters.max_neighbours, flocking_parameters.max_neighbours);
+    private_nh.param("max_pose_age", flocking_parameters.max_pose_age, flocking_parameters.max_pose_age);
+    flocking.setParameters(flocking_parameters);
+
+    joySubscriber = control_nh.subscribe((rover_name + "/joystick"), 10, &MobilityNode::joyCmdHandler, this);
+    modeSubscriber = control_nh.subscribe((rover_name + "/mode"), 1, &MobilityNode::modeHandler, this);
+    odometrySubscriber = control_nh.subscribe((rover_name + "/odom/ekf"), 10, &MobilityNode::odometryHandler, this);
+    targetSubscriber = nh.subscribe((rover_name + "/targets"), 10, &MobilityNode::targetHandler, this);
+    obstacleSubscriber = nh.subscribe((rover_name + "/obstacle"), 10, &MobilityNode::obstacleHandler, this);
+    messageSubscriber = swarm_nh.subscribe(("messages"), 10, &MobilityNode::messageHandler, this);
+    poseSubscriber = swarm_nh.subscribe(("poses"), 10, &MobilityNode::poseHandler, this);
+
+    status_publisher = nh.advertise<std_msgs::String>((rover_name + "/status"), 1, true);
+    velocityPublish = nh.advertise<geometry_msgs::Twist>((rover_name + "/velocity"), 10);
+    if (verbosity >= VERBOSITY_STATE)
+        stateMachinePublish = nh.advertise<std_msgs::String>((rover_name + "/state_machine"), 1, true);
+    messagePublish = nh.advertise<std_msgs::String>(("messages"), 10, true);
+    target_collected_publisher = nh.advertise<std_msgs::Int16>(("targetsCollected"), 1, true);
+    telemetry_publisher = nh.advertise<shared_messages::MobilityTelemetry>((rover_name + "/telemetry"), 10);
+    control_jitter_publisher = nh.advertise<std_msgs::Float32>((rover_name + "/control_jitter"), 10);
+    diagnostics_publisher = nh.advertise<shared_messages::MobilityDiagnostics>((rover_name + "/mobility_diagnostics"), 1);
+
+    // Announce this rover on the shared registry topic. Latched so a GUI that starts later sees it immediately.
+    heartbeat_publisher = nh.advertise<shared_messages::RoverHeartbeat>("/rovers/registry", 10, true);
+
+    posePublish = nh.advertise<shared_messages::PoseShare>(("poses"), 10, true);
+    if (verbosity >= VERBOSITY_DEBUG)
+    {
+        global_average_heading = nh.advertise<std_msgs::String>(("global_average_heading"), 10, true);
+        local_average_heading = nh.advertise<std_msgs::String>(("local_average_heading"), 10, true);
+    }
+
+    publish_status_timer = nh.createTimer(ros::Duration(status_publish_interval), &MobilityNode::publishStatusTimerEventHandler, this);
+    heartbeat_timer = nh.createTimer(ros::Duration(heartbeat_interval), &MobilityNode::heartbeatTimerEventHandler, this);
+    diagnostics_timer = nh.createTimer(ros::Duration(diagnostics_interval), &MobilityNode::diagnosticsTimerEventHandler, this);
+    killSwitchTimer = control_nh.createTimer(ros::Duration(kill_switch_timeout), &MobilityNode::killSwitchTimerEventHandler, this);
+    stateMachineTimer = control_nh.createTimer(ros::Duration(mobility_loop_time_step), &MobilityNode::mobilityStateMachine, this);
+}
+
+void MobilityNode::run()
+{
+    control_spinner.start();
+    swarm_spinner.start();
+
+    // Like ros::spin(), but also wakes up regularly to see whether a signal asked us to stop
+    ros::CallbackQueue* queue = ros::getGlobalCallbackQueue();
+    while (ros::ok() && !shutdown_requested) queue->callAvailable(ros::WallDuration(0.1));
+
+    if (ros::ok())
+    {
+        // Tell the GUI we are leaving so it does not have to wait for the heartbeat to time out.
+        // Publishing only queues the message, so give the network threads a moment to send it.
+        publishHeartbeat(true);
+        ros::WallDuration(0.2).sleep();
+    }
+
+    control_spinner.stop();
+    swarm_spinner.stop();
+    ros::shutdown();
+
+    logDiagnostics();
+}
+
+void MobilityNode::requestShutdown()
+{
+    shutdown_requested = 1;
+}
+
+void MobilityNode::mobilityStateMachine(const ros::TimerEvent& event)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int state;
+
+    measurePeriod(event);
+    updateFlocking();
+
+    if ((simulation_mode == 2 || simulation_mode == 3)) // Robot is in automode
+    {
+        if (transitions_to_auto == 0)
+        {
+            // This is the first time we have clicked the Autonomous Button. Log the time and increment the counter.
+            transitions_to_auto++;
+            time_stamp_transition_to_auto = ros::Time::now().toSec();
+        }
+        switch (state_machine_state)
+        {
+        case STATE_MACHINE_TRANSLATE:
+        {
+            float k = 0.1;
+            state = shared_messages::MobilityTelemetry::STATE_TRANSLATING;
+            //float angular_velocity = k * (local_average - current_location.theta);
+            //float angular_velocity = k * (glob_average - current_location.theta);
+            //float angular_velocity = k * (local_average_position - current_location.theta);
+            float angular_velocity = k * angles::shortest_angular_distance(current_location.theta, combined_theta);
+            float linear_velocity = 0.05;
+            setVelocity(linear_velocity, angular_velocity);
+
+            break;
+        }
+        default:
+        {
+            state = shared_messages::MobilityTelemetry::STATE_UNKNOWN;
+            break;
+        }
+        }
+
+    }
+    else
+    { // mode is NOT auto
+        state = shared_messages::MobilityTelemetry::STATE_WAITING;
+    }
+
+    shared_messages::PoseShare pose_msg;
+    pose_msg.rover_id = swarm_index;
+    pose_msg.stamp = ros::Time::now();
+    pose_msg.x = current_location.x;
+    pose_msg.y = current_location.y;
+    pose_msg.theta = current_location.theta;
+    pose_msg.velocity = current_velocity;
+    posePublish.publish(pose_msg);
+
+    publishTelemetry(state, pose_msg.stamp);
+    if (verbosity >= VERBOSITY_STATE) publishStateString(state);
+
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+    execution_histogram.record(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
+
+void MobilityNode::publishTelemetry(int state, const ros::Time& stamp)
+{
+    shared_messages::MobilityTelemetry telemetry;
+    telemetry.header.stamp = stamp;
+    telemetry.state = state;
+    telemetry.mode = simulation_mode;
+    telemetry.theta = current_location.theta;
+    telemetry.combined_theta = combined_theta;
+    telemetry.local_average = local_average;
+    telemetry.local_average_position = local_average_position;
+    telemetry.global_average = glob_average;
+    telemetry.num_neighbours = num_neighbours;
+    telemetry.current_velocity = current_velocity;
+    telemetry.linear_velocity = linear_velocity_command;
+    telemetry.angular_velocity = angular_velocity_command;
+    telemetry_publisher.publish(telemetry);
+}
+
+// The topic is latched, so it only needs publishing when the text would change
+void MobilityNode::publishStateString(int state)
+{
+    if (state == published_state && simulation_mode == published_mode) return;
+    published_state = state;
+    published_mode = simulation_mode;
+
+    std_msgs::String state_machine_msg;
+    switch (state)
+    {
+    case shared_messages::MobilityTelemetry::STATE_WAITING:
+    {
+        // publish current state for the operator to see
+        std::stringstream converter;
+        converter <<"CURRENT MODE: " << simulation_mode;
+
+        state_machine_msg.data = "WAITING, " + converter.str();
+        break;
+    }
+    case shared_messages::MobilityTelemetry::STATE_TRANSLATING:
+        state_machine_msg.data = "TRANSLATING";
+        break;
+    default:
+        state_machine_msg.data = "DEFAULT CASE: SOMETHING WRONG!!!!";
+        break;
+    }
+
+    stateMachinePublish.publish(state_machine_msg);
+}
+
+// Records the period and publishes the jitter: the actual period minus the nominal one, positive when the tick ran late
+void MobilityNode::measurePeriod(const ros::TimerEvent& event)
+{
+    // The first tick has no previous one to measure from
+    if (event.last_real.isZero()) return;
+
+    double period = (event.current_real - event.last_real).toSec();
+    period_histogram.recordSeconds(period);
+
+    std_msgs::Float32 jitter;
+    jitter.data = period - mobility_loop_time_step;
+    control_jitter_publisher.publish(jitter);
+}
+
+void MobilityNode::setVelocity(double linear_velocity, double angular_velocity)
+{
+    geometry_msgs::Twist velocity;
+    // Stopping and starting the timer causes it to start counting from 0 again.
+    // As long as this is called before the kill switch timer reaches kill_switch_timeout seconds
+    // the rover's kill switch wont be called.
+    killSwitchTimer.stop();
+    killSwitchTimer.start();
+
+    linear_velocity_command = linear_velocity;
+    angular_velocity_command = angular_velocity;
+
+    if (!odometry_stamp.isZero()) command_latency_histogram.recordSeconds((ros::Time::now() - odometry_stamp).toSec());
+
+    velocity.linear.x = linear_velocity * 1.5;
+    velocity.angular.z = angular_velocity * 8; //scaling factor for sim; removed by aBridge node
+    velocityPublish.publish(velocity);
+}
+
+void MobilityNode::updateFlocking()
+{
+    double now = ros::Time::now().toSec();
+    FlockingEngine::Result result;
+    {
+        std::lock_guard<std::mutex> lock(flocking_mutex);
+        flocking.expire(now);
+        result = flocking.compute(swarm_index, current_location.x, current_location.y, current_location.theta, now);
+    }
+
+    glob_average = result.global_average;
+    local_average = result.local_average;
+    local_average_position = result.local_average_position;
+    combined_theta = result.combined_theta;
+    num_neighbours = result.num_neighbours;
+
+    if (verbosity < VERBOSITY_DEBUG) return;
+
+    std_msgs::String pose_msg;
+
+    std::stringstream converter;
+    converter << "Global Average Theta = " << glob_average;
+    pose_msg.data = converter.str();
+    global_average_heading.publish(pose_msg);
+
+    std::stringstream gat;
+    gat << rover_name << " with " << result.num_neighbours << " neighbors with Combine Theta = " << combined_theta;
+    pose_msg.data = gat.str();
+    local_average_heading.publish(pose_msg);
+}
+
+/***********************
+ * ROS CALLBACK HANDLERS
+ ************************/
+void MobilityNode::targetHandler(const shared_messages::TagsImage::ConstPtr& message)
+{
+    // Only used if we want to take action after seeing an April Tag.
+}
+
+void MobilityNode::modeHandler(const std_msgs::UInt8::ConstPtr& message)
+{
+    simulation_mode = message->data;
+    setVelocity(0.0, 0.0);
+}
+
+void MobilityNode::obstacleHandler(const std_msgs::UInt8::ConstPtr& message)
+{
+    if ( message->data > 0 )
+    {
+        if (message->data == 1)
+        {
+            // obstacle on right side
+        }
+        else
+        {
+            //obstacle in front or on left side
+        }
+    }
+}
+
+void MobilityNode::odometryHandler(const nav_msgs::Odometry::ConstPtr& message)
+{
+    //Get (x,y) location directly from pose
+    current_location.x = message->pose.pose.position.x;
+    current_location.y = message->pose.pose.position.y;
+
+    //Get theta rotation from the quaternion orientation. Only yaw is needed so skip building the full rotation matrix.
+    shared_math::Quat q(message->pose.pose.orientation.w, message->pose.pose.orientation.x,
+                        message->pose.pose.orientation.y, message->pose.pose.orientation.z);
+    current_location.theta = q.yaw();
+
+    current_velocity = message->twist.twist.linear.x;
+
+    // Some odometry sources leave the stamp empty. Then the best we know is when it arrived.
+    odometry_stamp = message->header.stamp.isZero() ? ros::Time::now() : message->header.stamp;
+}
+
+void MobilityNode::joyCmdHandler(const geometry_msgs::Twist::ConstPtr& message)
+{
+    if (simulation_mode == 0 || simulation_mode == 1)
+    {
+        setVelocity(message->linear.x, message->angular.z);
+    }
+}
+
+void MobilityNode::publishStatusTimerEventHandler(const ros::TimerEvent&)
+{
+    if (!is_published_name)
+    {
+        std_msgs::String name_msg;
+        name_msg.data = "I ";
+        name_msg.data = name_msg.data + rover_name;
+        messagePublish.publish(name_msg);
+        is_published_name = true;
+    }
+
+    std_msgs::String msg;
+    msg.data = "online";
+    status_publisher.publish(msg);
+}
+
+void MobilityNode::heartbeatTimerEventHandler(const ros::TimerEvent&)
+{
+    publishHeartbeat(false);
+}
+
+void MobilityNode::publishHeartbeat(bool leaving)
+{
+    shared_messages::RoverHeartbeat msg;
+    msg.header.stamp = ros::Time::now();
+    msg.rover_name = rover_name;
+    msg.period = heartbeat_interval;
+    msg.leaving = leaving;
+    heartbeat_publisher.publish(msg);
+}
+
+void MobilityNode::diagnosticsTimerEventHandler(const ros::TimerEvent&)
+{
+    shared_messages::MobilityDiagnostics msg;
+    msg.header.stamp = ros::Time::now();
+    msg.rover_name = rover_name;
+    fillHistogram(period_histogram, msg.period);
+    fillHistogram(execution_histogram, msg.execution);
+    fillHistogram(command_latency_histogram, msg.command_latency);
+    diagnostics_publisher.publish(msg);
+}
+
+void MobilityNode::logDiagnostics()
+{
+    ROS_INFO("%s control loop period: %s", rover_name.c_str(), period_histogram.summary().c_str());
+    ROS_INFO("%s control loop execution: %s", rover_name.c_str(), execution_histogram.summary().c_str());
+    ROS_INFO("%s odometry to command latency: %s", rover_name.c_str(), command_latency_histogram.summary().c_str());
+}
+
+// Safety precaution. No movement commands - might have lost contact with ROS. Stop the rover.
+// Also might no longer be receiving manual movement commands so stop the rover.
+void MobilityNode::killSwitchTimerEventHandler(const ros::TimerEvent&)
+{
+    // No movement commands for killSwitchTime seconds so stop the rover
+    setVelocity(0.0, 0.0);
+    double current_time = ros::Time::now().toSec();
+    ROS_INFO("In MobilityNode::killSwitchTimerEventHandler(): Movement input timeout. Stopping the rover at %6.4f.",
+             current_time);
+}
+
+void MobilityNode::messageHandler(const std_msgs::String::ConstPtr& message)
+{
+}
+
+// Only records the pose. Flocking is computed once per control tick by updateFlocking(), not once per message.
+void MobilityNode::poseHandler(const ros::MessageEvent<shared_messages::PoseShare const>& event)
+{
+    const shared_messages::PoseShare::ConstPtr& message = event.getMessage();
+
+    // A second node publishing an id would overwrite the first one's row in the table, and one publishing our
+    // own id would be skipped as if it were us. Drop its poses and say so.
+    if (message->rover_id >= publisher_of_id.size()) publisher_of_id.resize(message->rover_id + 1);
+    std::string& publisher = publisher_of_id[message->rover_id];
+    if (publisher.empty()) publisher = event.getPublisherName();
+    else if (publisher != event.getPublisherName())
+    {
+        ROS_ERROR_THROTTLE(5, "%s and %s both share poses as rover_id %d. Give every rover its own swarm_index.",
+                           publisher.c_str(), event.getPublisherName().c_str(), message->rover_id);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(flocking_mutex);
+    flocking.update(message->rover_id, message->x, message->y, message->theta, message->velocity, message->stamp.toSec());
+}
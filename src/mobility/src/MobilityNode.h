@@ -0,0 +1,186 @@
+#ifndef MOBILITYNODE_H
+#define MOBILITYNODE_H
+
+#include <csignal>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ros/ros.h>
+#include <ros/callback_queue.h>
+#include <random_numbers/random_numbers.h>
+
+#include <std_msgs/String.h>
+#include <std_msgs/UInt8.h>
+#include <geometry_msgs/Twist.h>
+#include <nav_msgs/Odometry.h>
+
+#include <shared_messages/TagsImage.h>
+#include <shared_messages/PoseShare.h>
+
+#include "Pose.h"
+#include "FlockingEngine.h"
+#include "TimingHistogram.h"
+
+/**
+ * The mobility node. Owns every publisher, subscriber, timer and piece of
+ * rover state that used to be a global in mobility.cpp.
+ *
+ * Callbacks are split over three queues, each served by its own thread:
+ *   control  odometry, joystick, mode, and the state machine and kill switch
+ *            timers. One thread, so these never overlap and share the rover
+ *            state without locks.
+ *   swarm    pose sharing and the messages topic. A burst of poses from a
+ *            large swarm queues up here instead of delaying a control tick.
+ *   default  status, heartbeat, targets and obstacles, spun by run().
+ * The pose table is the only state written on one queue and read on another,
+ * so it is the only state behind a mutex.
+ *
+ * Every tick publishes a shared_messages::MobilityTelemetry on
+ * <rover>/telemetry. The human readable string topics are only published as
+ * far as the verbosity param asks for.
+ *
+ * Every tick also publishes how far the state machine period was off
+ * mobility_loop_time_step, in seconds, on <rover>/control_jitter.
+ *
+ * The control loop also keeps histograms of the tick period, the time spent
+ * in each tick and the age of the odometry each velocity command is based on.
+ * Recording is lock free and costs a few nanoseconds per sample. The histograms
+ * are published once a second on <rover>/mobility_diagnostics and logged
+ * when run() returns.
+ */
+class MobilityNode
+{
+
+public:
+    // Every index must fit in PoseShare's uint8 rover_id
+    static const int MAX_SWARM_SIZE = 256;
+
+    // swarm_index is this rover's place in a swarm of swarm_size rovers, 0 to swarm_size - 1
+    MobilityNode(const std::string& rover_name, int swarm_index, int swarm_size);
+
+    // Serves the callback queues until requestShutdown() or ros::shutdown(). After a requested shutdown it
+    // publishes the leaving heartbeat and then shuts ROS down itself.
+    void run();
+
+    // Async-signal-safe: only sets a flag that run() polls, so it can be called from a SIGINT handler
+    static void requestShutdown();
+
+private:
+    // Control queue
+    void odometryHandler(const nav_msgs::Odometry::ConstPtr& message);
+    void joyCmdHandler(const geometry_msgs::Twist::ConstPtr& message);
+    void modeHandler(const std_msgs::UInt8::ConstPtr& message);
+    void mobilityStateMachine(const ros::TimerEvent& event);
+    void killSwitchTimerEventHandler(const ros::TimerEvent& event);
+    void setVelocity(double linear_velocity, double angular_velocity);
+    void updateFlocking();
+    void measurePeriod(const ros::TimerEvent& event);
+    void publishTelemetry(int state, const ros::Time& stamp);
+    void publishStateString(int state);
+
+    // Swarm queue
+    void poseHandler(const ros::MessageEvent<shared_messages::PoseShare const>& event);
+    void messageHandler(const std_msgs::String::ConstPtr& message);
+
+    // Default queue
+    void targetHandler(const shared_messages::TagsImage::ConstPtr& message);
+    void obstacleHandler(const std_msgs::UInt8::ConstPtr& message);
+    void publishStatusTimerEventHandler(const ros::TimerEvent& event);
+    void heartbeatTimerEventHandler(const ros::TimerEvent& event);
+    void publishHeartbeat(bool leaving);
+    void diagnosticsTimerEventHandler(const ros::TimerEvent& event);
+    void logDiagnostics();
+
+    // Declared before everything that registers callbacks on them, so they are destroyed last
+    ros::CallbackQueue control_queue;
+    ros::CallbackQueue swarm_queue;
+
+    ros::NodeHandle nh;         // Default queue
+    ros::NodeHandle control_nh;
+    ros::NodeHandle swarm_nh;
+
+    std::string rover_name;
+    random_numbers::RandomNumberGenerator rng;
+
+    // Position of this rover in the swarm. Shares out the search pattern and is the rover's id in the shared poses.
+    int swarm_index;
+    int swarm_size;
+
+    float mobility_loop_time_step;
+    float status_publish_interval;
+    float heartbeat_interval;
+    float kill_switch_timeout;
+    int verbosity;              // Which string topics to publish, see MobilityNode.cpp
+
+    // Owned by the control queue
+    int simulation_mode;
+    pose current_location;
+    float current_velocity;
+    int transitions_to_auto;
+    double time_stamp_transition_to_auto;
+    int state_machine_state;
+    ros::Time odometry_stamp;   // Of the odometry current_location came from
+    float linear_velocity_command;  // Last sent by setVelocity()
+    float angular_velocity_command;
+    int published_state;        // Last text on <rover>/state_machine, -1 before the first
+    int published_mode;
+
+    // theta averages, recomputed at the start of every control tick
+    float glob_average;
+    float local_average;
+    float local_average_position;
+    float combined_theta;
+    int num_neighbours;
+
+    // Latest pose shared by every rover in the swarm. Written by the swarm queue, read by the control queue.
+    std::mutex flocking_mutex;
+    FlockingEngine flocking;
+
+    // Owned by the swarm queue. The node each rover_id was first heard from, so two rovers
+    // configured with the same swarm_index are reported instead of silently sharing a row.
+    std::vector<std::string> publisher_of_id;
+
+    // Owned by the default queue
+    bool is_published_name;
+
+    // Written by the control queue, read by the default queue
+    TimingHistogram period_histogram;
+    TimingHistogram execution_histogram;
+    TimingHistogram command_latency_histogram;
+
+    ros::Publisher velocityPublish;
+    ros::Publisher stateMachinePublish;
+    ros::Publisher status_publisher;
+    ros::Publisher heartbeat_publisher;
+    ros::Publisher target_collected_publisher;
+    ros::Publisher messagePublish;
+    ros::Publisher posePublish;
+    ros::Publisher global_average_heading;
+    ros::Publisher local_average_heading;
+    ros::Publisher control_jitter_publisher;
+    ros::Publisher telemetry_publisher;
+    ros::Publisher diagnostics_publisher;
+
+    ros::Subscriber joySubscriber;
+    ros::Subscriber modeSubscriber;
+    ros::Subscriber targetSubscriber;
+    ros::Subscriber obstacleSubscriber;
+    ros::Subscriber odometrySubscriber;
+    ros::Subscriber poseSubscriber;
+    ros::Subscriber messageSubscriber;
+
+    ros::Timer stateMachineTimer;
+    ros::Timer publish_status_timer;
+    ros::Timer heartbeat_timer;
+    ros::Timer killSwitchTimer;
+    ros::Timer diagnostics_timer;
+
+    static volatile std::sig_atomic_t shutdown_requested;
+
+    // Declared last so their threads stop before any of the above is destroyed
+    ros::AsyncSpinner control_spinner;
+    ros::AsyncSpinner swarm_spinner;
+};
+
+#endif // MOBILITYNODE_H
@@ -0,0 +1,229 @@
+#ifndef PID_H
+#define PID_H
+
+#include <cmath>
+#include "Pose.h"
+
+/**
+ * One PID controller for every kind of goal. What differs between controllers
+ * is chosen at compile time by policy classes, so a controller has no virtual
+ * calls and every combination inlines to straight line code:
+ *
+ *   ErrorPolicy  error(current, goal) plus when the goal has changed and when
+ *                it counts as reached. See HeadingToGoalError, DistanceToGoalError
+ *                and GoalThetaError below.
+ *   Gains        static constexpr KP, KI and KD.
+ *   AntiWindup   how the integrator is updated. See NoAntiWindup and
+ *                ConditionalIntegration.
+ *   OutputClamp  limits the output. See NoClamp and MaxVelocityClamp.
+ *
+ * step() is the discrete form for a measured time step dt in seconds: the
+ * integrator accumulates error*dt and the derivative is the change in error
+ * divided by dt. The overload without dt uses the nominal step given to the
+ * constructor, for callers on a fixed rate timer.
+ */
+template <typename ErrorPolicy, typename Gains, typename AntiWindup, typename OutputClamp>
+class PID
+{
+
+public:
+    explicit PID(float nominal_dt = 0.1) : nominal_dt(nominal_dt)
+    {
+        reset();
+        goal_location_prior.x = 0;
+        goal_location_prior.y = 0;
+        goal_location_prior.theta = 0;
+    }
+
+    // Output for a step of dt seconds since the previous call. dt <= 0 skips the integral and derivative terms.
+    float step(const pose& current_location, const pose& goal_location, float dt)
+    {
+        if (ErrorPolicy::isGoalChanged(goal_location_prior, goal_location))
+        {
+            reset();
+            goal_location_prior = goal_location;
+        }
+
+        current_error = ErrorPolicy::error(current_location, goal_location);
+
+        float error_derivative = 0;
+        if (has_prior_error && dt > 0) error_derivative = (current_error - prior_error) / dt;
+
+        float candidate_integrator = integrator;
+        if (dt > 0) candidate_integrator += current_error * dt;
+
+        float unclamped = Gains::KP*current_error + Gains::KI*candidate_integrator + Gains::KD*error_derivative;
+        float output = OutputClamp::clamp(unclamped);
+
+        integrator = AntiWindup::update(integrator, candidate_integrator, current_error, unclamped, output);
+        prior_error = current_error;
+        has_prior_error = true;
+        return output;
+    }
+
+    float step(const pose& current_location, const pose& goal_location)
+    {
+        return step(current_location, goal_location, nominal_dt);
+    }
+
+    bool isGoalReached(const pose& current_location, const pose& goal_location) const
+    {
+        return ErrorPolicy::isGoalReached(current_location, goal_location);
+    }
+
+    void reset()
+    {
+        integrator = 0;
+        prior_error = 0;
+        current_error = 0;
+        has_prior_error = false;
+    }
+
+    float getCurrentError() const { return current_error; }
+    float getIntegrator() const { return integrator; }
+
+private:
+    float nominal_dt;
+    float integrator;
+    float prior_error;
+    float current_error;
+    bool has_prior_error;
+    pose goal_location_prior;
+};
+
+// Signed angle in [-pi, pi] to turn from heading from to heading to. Same as angles::shortest_angular_distance.
+inline float shortestAngularDistance(float from, float to)
+{
+    return std::remainder(to - from, static_cast<float>(2*M_PI));
+}
+
+/*
+ * Error policies
+ */
+
+// Heading error towards the goal point, for turning to face a waypoint. goal_location.theta is not used.
+struct HeadingToGoalError
+{
+    static float error(const pose& current_location, const pose& goal_location)
+    {
+        float goal_heading = atan2(goal_location.y - current_location.y, goal_location.x - current_location.x);
+        return shortestAngularDistance(current_location.theta, goal_heading);
+    }
+
+    static bool isGoalChanged(const pose& prior, const pose& goal_location)
+    {
+        return hypotf(goal_location.x - prior.x, goal_location.y - prior.y) > 1E-6;
+    }
+
+    static bool isGoalReached(const pose& current_location, const pose& goal_location)
+    {
+        return fabs(error(current_location, goal_location)) < 0.25; // radians around the heading to the waypoint
+    }
+};
+
+// Distance to the goal point, for driving to a waypoint
+struct DistanceToGoalError
+{
+    static float error(const pose& current_location, const pose& goal_location)
+    {
+        return hypotf(goal_location.x - current_location.x, goal_location.y - current_location.y);
+    }
+
+    static bool isGoalChanged(const pose& prior, const pose& goal_location)
+    {
+        return hypotf(goal_location.x - prior.x, goal_location.y - prior.y) > 1E-6;
+    }
+
+    static bool isGoalReached(const pose& current_location, const pose& goal_location)
+    {
+        return error(current_location, goal_location) < 0.5; // meter circle around the waypoint
+    }
+};
+
+// Heading error towards goal_location.theta, for holding a heading
+struct GoalThetaError
+{
+    static float error(const pose& current_location, const pose& goal_location)
+    {
+        return shortestAngularDistance(current_location.theta, goal_location.theta);
+    }
+
+    static bool isGoalChanged(const pose& prior, const pose& goal_location)
+    {
+        return fabs(shortestAngularDistance(prior.theta, goal_location.theta)) > 1E-6;
+    }
+
+    static bool isGoalReached(const pose& current_location, const pose& goal_location)
+    {
+        return fabs(error(current_location, goal_location)) < 0.25; // radians around the goal heading
+    }
+};
+
+/*
+ * Anti-windup policies. update() returns the integrator to keep, given the old one, the one the output was
+ * computed with, and the output before and after clamping.
+ */
+
+struct NoAntiWindup
+{
+    static float update(float, float candidate_integrator, float, float, float)
+    {
+        return candidate_integrator;
+    }
+};
+
+// Stops integrating while the output is clamped and the error would push it further into the limit
+struct ConditionalIntegration
+{
+    static float update(float integrator, float candidate_integrator, float error, float unclamped, float clamped)
+    {
+        if (unclamped != clamped && error*unclamped > 0) return integrator;
+        return candidate_integrator;
+    }
+};
+
+/*
+ * Output clamp policies
+ */
+
+struct NoClamp
+{
+    static float clamp(float output) { return output; }
+};
+
+// Limits the output to +-MAX_VELOCITY, the fastest the controllers may command
+struct MaxVelocityClamp
+{
+    static constexpr float MAX_VELOCITY = 0.3;
+
+    static float clamp(float output)
+    {
+        if (output > MAX_VELOCITY) return MAX_VELOCITY;
+        if (output < -MAX_VELOCITY) return -MAX_VELOCITY;
+        return output;
+    }
+};
+
+/*
+ * The controllers used on the rovers
+ */
+
+struct RotationalGains
+{
+    static constexpr float KP = 1.25;
+    static constexpr float KI = 0.0;
+    static constexpr float KD = 0.0;
+};
+
+struct TranslationalGains
+{
+    static constexpr float KP = 1.5;
+    static constexpr float KI = 0.01;   // 0.001 per 0.1 s loop step before steps were scaled by dt
+    static constexpr float KD = 0.0;
+};
+
+typedef PID<HeadingToGoalError, RotationalGains, ConditionalIntegration, MaxVelocityClamp> RotationalController;
+typedef PID<DistanceToGoalError, TranslationalGains, ConditionalIntegration, MaxVelocityClamp> TranslationalController;
+typedef PID<GoalThetaError, RotationalGains, ConditionalIntegration, MaxVelocityClamp> ThetaController;
+
+#endif // PID_H
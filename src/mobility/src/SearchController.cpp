@@ -1,4 +1,6 @@
 #include "SearchController.h"
+#include <algorithm>
+#include <vector>
 //#include "Vec2D.hpp"
 
 SearchController::SearchController()
@@ -6,56 +8,37 @@ SearchController::SearchController()
     rng = new random_numbers::RandomNumberGenerator();
 }
 
-SearchController::SearchController(std::string rover_name)
+// Square spiral search (DDSA) shared out between the rovers of a swarm. Rover swarm_index starts on the ring at
+// (swarm_size - swarm_index)*d from the collection zone and moves out swarm_size*d per loop, so the swarm's rings
+// interleave d apart until they reach the search boundary. d shrinks for large swarms so every rover gets at least
+// one ring inside the boundary.
+SearchController::SearchController(int swarm_index, int swarm_size)
 {
-    const float d = 0.5;
-    const float OUTER_BOUNDARY = 7.5;
-    const bool DDSA = true;
-    if (DDSA)
-    {
-        float waypoints_x1 [] = {0.000000, 0.500000, 0.500000, -0.500000, -0.500000, 2.000000, 2.000000, -2.000000, -2.000000, 3.500000, 3.500000, -3.500000, -3.500000, 5.000000, 5.000000, -5.000000, -5.000000, 6.500000, 6.500000, -6.500000, -6.500000};
-        float waypoints_y1 [] = {0.500000, 0.500000, -0.500000, -0.500000, 2.000000, 2.000000, -2.000000, -2.000000, 3.500000, 3.500000, -3.500000, -3.500000, 5.000000, 5.000000, -5.000000, -5.000000, 6.500000, 6.500000, -6.500000, -6.500000, 7.000000};
-        float waypoints_x2 [] = {0.000000, 1.000000, 1.000000, -1.000000, -1.000000, 2.500000, 2.500000, -2.500000, -2.500000, 4.000000, 4.000000, -4.000000, -4.000000, 5.500000, 5.500000, -5.500000, -5.500000, 7.000000, 7.000000, -7.000000, -7.000000};
-        float waypoints_y2 [] = {1.000000, 1.000000, -1.000000, -1.000000, 2.500000, 2.500000, -2.500000, -2.500000, 4.000000, 4.000000, -4.000000, -4.000000, 5.500000, 5.500000, -5.500000, -5.500000, 7.000000, 7.000000, -7.000000, -7.000000, 7.000000};
-        float waypoints_x3 [] = {0.000000, 1.500000, 1.500000, -1.500000, -1.500000, 3.000000, 3.000000, -3.000000, -3.000000, 4.500000, 4.500000, -4.500000, -4.500000, 6.000000, 6.000000, -6.000000, -6.000000};
-        float waypoints_y3 [] = {1.500000, 1.500000, -1.500000, -1.500000, 3.000000, 3.000000, -3.000000, -3.000000, 4.500000, 4.500000, -4.500000, -4.500000, 6.000000, 6.000000, -6.000000, -6.000000, 7.000000};
-        if (rover_name == "achilles")
-        {
-            int array_length = sizeof(waypoints_x3)/sizeof(waypoints_x3[0]);
-            fillStack(waypoints_x3, waypoints_y3, array_length);
-        }
-        else if (rover_name == "ajax")
-        {
-            int array_length = sizeof(waypoints_x1)/sizeof(waypoints_x1[0]);
-            fillStack(waypoints_x1, waypoints_y1, array_length);
-        }
-        else if (rover_name == "aeneas")
-        {
-            int array_length = sizeof(waypoints_x2)/sizeof(waypoints_x2[0]);
-            fillStack(waypoints_x2, waypoints_y2, array_length);
-        }
-    }
-    else
+    rng = new random_numbers::RandomNumberGenerator();
+
+    const float SEARCH_BOUNDARY = 7.0;
+    if (swarm_size < 1) swarm_size = 1;
+    if (swarm_index < 0 || swarm_index >= swarm_size) swarm_index = 0;
+
+    float d = std::min(0.5f, SEARCH_BOUNDARY/swarm_size);
+    float first_ring = (swarm_size - swarm_index)*d;
+    float ring_step = swarm_size*d;
+
+    std::vector<float> waypoints_x(1, 0);
+    std::vector<float> waypoints_y(1, first_ring);
+    for (float r = first_ring; r <= SEARCH_BOUNDARY + 0.001; r += ring_step)
     {
-        //float waypoints_x1 [] = {OUTER_BOUNDARY-d, -(OUTER_BOUNDARY-d), -(OUTER_BOUNDARY-d),    OUTER_BOUNDARY-d,   OUTER_BOUNDARY-d, -(OUTER_BOUNDARY-2*d), -(OUTER_BOUNDARY-2*d),    OUTER_BOUNDARY-2*d, OUTER_BOUNDARY-2*d, -(OUTER_BOUNDARY-3*d), -(OUTER_BOUNDARY-3*d),    OUTER_BOUNDARY-3*d, OUTER_BOUNDARY-3*d, -(OUTER_BOUNDARY-4*d), -(OUTER_BOUNDARY-4*d),   OUTER_BOUNDARY-4*d, OUTER_BOUNDARY-4*d, OUTER_BOUNDARY-4*d, -(OUTER_BOUNDARY-5*d), -(OUTER_BOUNDARY-5*d),    OUTER_BOUNDARY-5*d,    OUTER_BOUNDARY-5*d};
-        //float waypoints_y1 [] = {OUTER_BOUNDARY-d,    OUTER_BOUNDARY-d, -(OUTER_BOUNDARY-d), -(OUTER_BOUNDARY-d), OUTER_BOUNDARY-2*d,    OUTER_BOUNDARY-2*d, -(OUTER_BOUNDARY-2*d), -(OUTER_BOUNDARY-2*d), OUTER_BOUNDARY-3*d,    OUTER_BOUNDARY-3*d, -(OUTER_BOUNDARY-3*d), -(OUTER_BOUNDARY-3*d), OUTER_BOUNDARY-4*d,    OUTER_BOUNDARY-4*d, -(OUTER_BOUNDARY-4*d), -(OUTER_BOUNDARY-4*d), OUTER_BOUNDARY-5*d, OUTER_BOUNDARY-5*d,    OUTER_BOUNDARY-5*d, -(OUTER_BOUNDARY-5*d), -(OUTER_BOUNDARY-5*d),    OUTER_BOUNDARY-6*d};
-        //float waypoints_x2 [] = {OUTER_BOUNDARY-5*d, -(OUTER_BOUNDARY-6*d), -(OUTER_BOUNDARY-6*d),    OUTER_BOUNDARY-6*d, OUTER_BOUNDARY-6*d, OUTER_BOUNDARY-6*d, -(OUTER_BOUNDARY-7*d), -(OUTER_BOUNDARY-7*d),    OUTER_BOUNDARY-7*d, OUTER_BOUNDARY-7*d, OUTER_BOUNDARY-7*d, -(OUTER_BOUNDARY-8*d), -(OUTER_BOUNDARY-8*d),    OUTER_BOUNDARY-8*d, OUTER_BOUNDARY-8*d, OUTER_BOUNDARY-8*d, -(OUTER_BOUNDARY-9*d), -(OUTER_BOUNDARY-9*d),   OUTER_BOUNDARY-9*d,   OUTER_BOUNDARY-9*d, OUTER_BOUNDARY-9*d, -(OUTER_BOUNDARY-10*d), -(OUTER_BOUNDARY-10*d),   OUTER_BOUNDARY-10*d,   OUTER_BOUNDARY-10*d, OUTER_BOUNDARY-10*d, -(OUTER_BOUNDARY-11*d), -(OUTER_BOUNDARY-11*d),    OUTER_BOUNDARY-11*d, OUTER_BOUNDARY-11*d, OUTER_BOUNDARY-11*d, -(OUTER_BOUNDARY-12*d), -(OUTER_BOUNDARY-12*d),    OUTER_BOUNDARY-12*d, OUTER_BOUNDARY-12*d};
-        //float waypoints_y2 [] = {OUTER_BOUNDARY-6*d,    OUTER_BOUNDARY-6*d, -(OUTER_BOUNDARY-6*d), -(OUTER_BOUNDARY-6*d), OUTER_BOUNDARY-7*d, OUTER_BOUNDARY-7*d,    OUTER_BOUNDARY-7*d, -(OUTER_BOUNDARY-7*d), -(OUTER_BOUNDARY-7*d), OUTER_BOUNDARY-8*d, OUTER_BOUNDARY-8*d,    OUTER_BOUNDARY-8*d, -(OUTER_BOUNDARY-8*d), -(OUTER_BOUNDARY-8*d), OUTER_BOUNDARY-9*d, OUTER_BOUNDARY-9*d,    OUTER_BOUNDARY-9*d, -(OUTER_BOUNDARY-9*d), -(OUTER_BOUNDARY-9*d), OUTER_BOUNDARY-10*d, OUTER_BOUNDARY-10*d,    OUTER_BOUNDARY-10*d, -(OUTER_BOUNDARY-10*d), -(OUTER_BOUNDARY-10*d), OUTER_BOUNDARY-11*d, OUTER_BOUNDARY-11*d,    OUTER_BOUNDARY-11*d, -(OUTER_BOUNDARY-11*d), -(OUTER_BOUNDARY-11*d), OUTER_BOUNDARY-12*d, OUTER_BOUNDARY-12*d,    OUTER_BOUNDARY-12*d, -(OUTER_BOUNDARY-12*d), -(OUTER_BOUNDARY-12*d), OUTER_BOUNDARY-13*d};
-        float waypoints_x1 [] = {0.000000, 0.500000, 0.500000, -0.500000, -0.500000, 1.000000, 1.000000, -1.000000, -1.000000, 1.500000, 1.500000, -1.500000, -1.500000, 2.000000, 2.000000, -2.000000, -2.000000, 2.500000, 2.500000, -2.500000, -2.500000, 3.000000, 3.000000, -3.000000, -3.000000, 3.500000, 3.500000, -3.500000, -3.500000, 4.000000, 4.000000, -4.000000, -4.000000, 4.500000, 4.500000, -4.500000, -4.500000, 5.000000, 5.000000, -5.000000, -5.000000};
-        float waypoints_y1 [] = {0.500000, 0.500000, -0.500000, -0.500000, 1.000000, 1.000000, -1.000000, -1.000000, 1.500000, 1.500000, -1.500000, -1.500000, 2.000000, 2.000000, -2.000000, -2.000000, 2.500000, 2.500000, -2.500000, -2.500000, 3.000000, 3.000000, -3.000000, -3.000000, 3.500000, 3.500000, -3.500000, -3.500000, 4.000000, 4.000000, -4.000000, -4.000000, 4.500000, 4.500000, -4.500000, -4.500000, 5.000000, 5.000000, -5.000000, -5.000000, 5.500000};
-        float waypoints_x2 [] = {-5.000000, 5.500000, 5.500000, -5.500000, -5.500000, 6.000000, 6.000000, -6.000000, -6.000000, 6.500000, 6.500000, -6.500000, -6.500000, 7.000000, 7.000000, -7.000000, -7.000000};
-        float waypoints_y2 [] = {5.500000, 5.500000, -5.500000, -5.500000, 6.000000, 6.000000, -6.000000, -6.000000, 6.500000, 6.500000, -6.500000, -6.500000, 7.000000, 7.000000, -7.000000, -7.000000, 7.000000};
-        if (rover_name == "ajax")
-        {
-            int array_length = sizeof(waypoints_x1)/sizeof(waypoints_x1[0]);
-            fillStack(waypoints_x1, waypoints_y1, array_length);
-        }
-        else if (rover_name == "aeneas")
-        {
-            int array_length = sizeof(waypoints_x2)/sizeof(waypoints_x2[0]);
-            fillStack(waypoints_x2, waypoints_y2, array_length);
-        }
+        // The last leg of each loop climbs to the next ring, or to the boundary after the last one
+        float next_ring = r + ring_step;
+        if (next_ring > SEARCH_BOUNDARY + 0.001) next_ring = SEARCH_BOUNDARY;
+
+        float loop_x [] = {r, r, -r, -r};
+        float loop_y [] = {r, -r, -r, next_ring};
+        waypoints_x.insert(waypoints_x.end(), loop_x, loop_x + 4);
+        waypoints_y.insert(waypoints_y.end(), loop_y, loop_y + 4);
     }
+
+    fillStack(&waypoints_x[0], &waypoints_y[0], waypoints_x.size());
 }
 
 void SearchController::fillStack(float waypoints_x [], float waypoints_y [], int array_length)
@@ -16,7 +16,9 @@ class SearchController {
   public:
 
     SearchController();
-    SearchController(std::string rover_name);
+
+    // Search pattern for rover swarm_index (0, 1, ...) of a swarm of swarm_size rovers
+    SearchController(int swarm_index, int swarm_size);
 
     void fillStack(float waypoints_x [], float waypoints_y [], int array_length);
     pose search(pose current_location);
@@ -0,0 +1,81 @@
+#include <sstream>
+#include "TimingHistogram.h"
+
+using namespace std;
+
+TimingHistogram::TimingHistogram()
+{
+    for (int i = 0; i < NUM_BUCKETS; i++) buckets[i].store(0);
+    sample_count.store(0);
+    sample_sum.store(0);
+    sample_max.store(0);
+}
+
+void TimingHistogram::record(uint64_t microseconds)
+{
+    // Index of the highest set bit, which is floor(log2)
+    int index = microseconds < 2 ? 0 : 63 - __builtin_clzll(microseconds);
+    if (index >= NUM_BUCKETS) index = NUM_BUCKETS - 1;
+
+    // No other thread writes, so load and store cannot lose an increment
+    buckets[index].store(buckets[index].load(memory_order_relaxed) + 1, memory_order_relaxed);
+    sample_count.store(sample_count.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    sample_sum.store(sample_sum.load(memory_order_relaxed) + microseconds, memory_order_relaxed);
+
+    uint32_t clamped = microseconds > UINT32_MAX ? UINT32_MAX : microseconds;
+    if (clamped > sample_max.load(memory_order_relaxed)) sample_max.store(clamped, memory_order_relaxed);
+}
+
+void TimingHistogram::recordSeconds(double seconds)
+{
+    record(seconds > 0 ? static_cast<uint64_t>(seconds*1E6) : 0);
+}
+
+uint32_t TimingHistogram::count() const
+{
+    return sample_count.load(memory_order_relaxed);
+}
+
+uint64_t TimingHistogram::sum() const
+{
+    return sample_sum.load(memory_order_relaxed);
+}
+
+uint32_t TimingHistogram::max() const
+{
+    return sample_max.load(memory_order_relaxed);
+}
+
+uint32_t TimingHistogram::bucket(int index) const
+{
+    return buckets[index].load(memory_order_relaxed);
+}
+
+uint64_t TimingHistogram::percentile(double fraction) const
+{
+    uint64_t total = 0;
+    for (int i = 0; i < NUM_BUCKETS; i++) total += bucket(i);
+    if (total == 0) return 0;
+
+    uint64_t cumulative = 0;
+    for (int i = 0; i < NUM_BUCKETS; i++)
+    {
+        cumulative += bucket(i);
+        if (cumulative >= fraction*total) return 2ULL << i;
+    }
+
+    return 2ULL << (NUM_BUCKETS - 1);
+}
+
+string TimingHistogram::summary() const
+{
+    uint32_t n = count();
+
+    ostringstream text;
+    text << "count " << n
+         << " mean " << (n > 0 ? sum()/n : 0) << "us"
+         << " p50 <" << percentile(0.5) << "us"
+         << " p99 <" << percentile(0.99) << "us"
+         << " max " << max() << "us";
+    return text.str();
+}
@@ -0,0 +1,51 @@
+#ifndef TIMINGHISTOGRAM_H
+#define TIMINGHISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * Histogram of durations with power of two buckets in microseconds. Bucket 0
+ * counts samples under 2 us and bucket i those in [2^i, 2^(i+1)) us. The last
+ * bucket, from about 8 s up, also takes everything longer.
+ *
+ * Only one thread may call record(), but any thread can read at any time.
+ * With a single writer every counter is updated by a relaxed atomic load and
+ * store instead of a locked read-modify-write, so a sample costs a few
+ * nanoseconds and never blocks. A reader may see a sample in count() before
+ * it shows up in its bucket. That is fine for monitoring.
+ */
+class TimingHistogram
+{
+
+public:
+    static const int NUM_BUCKETS = 24;
+
+    TimingHistogram();
+
+    // Single writer only, see above
+    void record(std::uint64_t microseconds);
+
+    // Negative durations, for example from clocks stepping back, count as zero
+    void recordSeconds(double seconds);
+
+    std::uint32_t count() const;
+    std::uint64_t sum() const;  // microseconds
+    std::uint32_t max() const;  // microseconds
+    std::uint32_t bucket(int index) const;
+
+    // Upper edge in microseconds of the bucket holding the given fraction (0 to 1) of the samples. 0 if empty.
+    std::uint64_t percentile(double fraction) const;
+
+    // One line, e.g. "count 600 mean 97us p50 <128us p99 <256us max 201us"
+    std::string summary() const;
+
+private:
+    std::atomic<std::uint32_t> buckets[NUM_BUCKETS];
+    std::atomic<std::uint32_t> sample_count;
+    std::atomic<std::uint64_t> sample_sum;
+    std::atomic<std::uint32_t> sample_max;
+};
+
+#endif // TIMINGHISTOGRAM_H
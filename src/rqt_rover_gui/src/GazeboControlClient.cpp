@@ -0,0 +1,188 @@
+#include "GazeboControlClient.h"
+#include <gazebo_msgs/SpawnModel.h>
+#include <gazebo_msgs/DeleteModel.h>
+#include <gazebo_msgs/SetModelState.h>
+#include <gazebo_msgs/ApplyBodyWrench.h>
+#include <shared_math/Quat.h>
+
+using namespace std;
+using shared_math::Quat;
+using shared_math::Vec3;
+
+// Service names advertised by the gazebo_ros API plugin
+static const string spawn_service = "/gazebo/spawn_sdf_model";
+static const string delete_service = "/gazebo/delete_model";
+static const string set_state_service = "/gazebo/set_model_state";
+static const string wrench_service = "/gazebo/apply_body_wrench";
+
+GazeboControlClient::GazeboControlClient(int worker_count)
+{
+    requests_in_flight = 0;
+    stopping = false;
+
+    // Last argument makes the clients persistent
+    spawn_client = nh.serviceClient<gazebo_msgs::SpawnModel>(spawn_service, true);
+    delete_client = nh.serviceClient<gazebo_msgs::DeleteModel>(delete_service, true);
+    set_state_client = nh.serviceClient<gazebo_msgs::SetModelState>(set_state_service, true);
+    wrench_client = nh.serviceClient<gazebo_msgs::ApplyBodyWrench>(wrench_service, true);
+
+    for (int i = 0; i < worker_count; i++)
+        workers.push_back(thread(&GazeboControlClient::workerLoop, this));
+}
+
+GazeboControlClient::~GazeboControlClient()
+{
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        stopping = true;
+        requests_in_flight -= queued_requests.size();
+        queued_requests.clear();
+    }
+    queue_not_empty.notify_all();
+    queue_drained.notify_all();
+
+    for (size_t i = 0; i < workers.size(); i++)
+        workers[i].join();
+}
+
+bool GazeboControlClient::waitForGazebo(double timeout)
+{
+    return ros::service::waitForService(spawn_service, ros::Duration(timeout));
+}
+
+QString GazeboControlClient::spawnModel(const string& model_name, const string& model_sdf, float x, float y, float z, float roll, float pitch, float yaw)
+{
+    SpawnRequest request = { model_name, model_sdf, x, y, z, roll, pitch, yaw };
+    return callSpawn(spawn_client, request);
+}
+
+QString GazeboControlClient::callSpawn(ros::ServiceClient& client, const SpawnRequest& request)
+{
+    // A persistent client stays invalid once its connection drops, e.g. when gazebo restarts
+    if (!client.isValid())
+        client = ros::NodeHandle().serviceClient<gazebo_msgs::SpawnModel>(spawn_service, true);
+
+    // Fixed axis roll, pitch, yaw as used by spawn_model -R -P -Y
+    Quat orientation = Quat::fromAxisAngle(Vec3(0,0,1), request.yaw)
+                     * Quat::fromAxisAngle(Vec3(0,1,0), request.pitch)
+                     * Quat::fromAxisAngle(Vec3(1,0,0), request.roll);
+
+    gazebo_msgs::SpawnModel srv;
+    srv.request.model_name = request.model_name;
+    srv.request.model_xml = request.model_sdf;
+    srv.request.initial_pose.position.x = request.x;
+    srv.request.initial_pose.position.y = request.y;
+    srv.request.initial_pose.position.z = request.z;
+    srv.request.initial_pose.orientation.w = orientation.w;
+    srv.request.initial_pose.orientation.x = orientation.x;
+    srv.request.initial_pose.orientation.y = orientation.y;
+    srv.request.initial_pose.orientation.z = orientation.z;
+
+    if (!client.call(srv)) return "Could not reach " + QString::fromStdString(spawn_service) + " to spawn " + QString::fromStdString(request.model_name);
+    if (!srv.response.success) return QString::fromStdString(srv.response.status_message);
+
+    return "";
+}
+
+QString GazeboControlClient::deleteModel(const string& model_name)
+{
+    if (!delete_client.isValid())
+        delete_client = nh.serviceClient<gazebo_msgs::DeleteModel>(delete_service, true);
+
+    gazebo_msgs::DeleteModel srv;
+    srv.request.model_name = model_name;
+
+    if (!delete_client.call(srv)) return "Could not reach " + QString::fromStdString(delete_service) + " to delete " + QString::fromStdString(model_name);
+    if (!srv.response.success) return QString::fromStdString(srv.response.status_message);
+
+    return "";
+}
+
+QString GazeboControlClient::setModelState(const string& model_name, float x, float y, float z)
+{
+    if (!set_state_client.isValid())
+        set_state_client = nh.serviceClient<gazebo_msgs::SetModelState>(set_state_service, true);
+
+    gazebo_msgs::SetModelState srv;
+    srv.request.model_state.model_name = model_name;
+    srv.request.model_state.pose.position.x = x;
+    srv.request.model_state.pose.position.y = y;
+    srv.request.model_state.pose.position.z = z;
+    srv.request.model_state.pose.orientation.w = 1;
+    srv.request.model_state.reference_frame = "world";
+
+    if (!set_state_client.call(srv)) return "Could not reach " + QString::fromStdString(set_state_service) + " to move " + QString::fromStdString(model_name);
+    if (!srv.response.success) return QString::fromStdString(srv.response.status_message);
+
+    return "";
+}
+
+QString GazeboControlClient::applyBodyWrench(const string& body_name, float x, float y, float z, float duration)
+{
+    if (!wrench_client.isValid())
+        wrench_client = nh.serviceClient<gazebo_msgs::ApplyBodyWrench>(wrench_service, true);
+
+    gazebo_msgs::ApplyBodyWrench srv;
+    srv.request.body_name = body_name;
+    srv.request.reference_frame = body_name;
+    srv.request.wrench.force.x = x;
+    srv.request.wrench.force.y = y;
+    srv.request.wrench.force.z = z;
+    srv.request.start_time = ros::Time(0); // now
+    srv.request.duration = ros::Duration(duration);
+
+    if (!wrench_client.call(srv)) return "Could not reach " + QString::fromStdString(wrench_service) + " to push " + QString::fromStdString(body_name);
+    if (!srv.response.success) return QString::fromStdString(srv.response.status_message);
+
+    return "";
+}
+
+void GazeboControlClient::queueSpawnModel(const string& model_name, const string& model_sdf, float x, float y, float z, float roll, float pitch, float yaw)
+{
+    SpawnRequest request = { model_name, model_sdf, x, y, z, roll, pitch, yaw };
+
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        queued_requests.push_back(request);
+        requests_in_flight++;
+    }
+    queue_not_empty.notify_one();
+}
+
+QString GazeboControlClient::waitForQueued()
+{
+    unique_lock<mutex> lock(queue_mutex);
+    while (requests_in_flight > 0) queue_drained.wait(lock);
+
+    QString errors = queued_errors;
+    queued_errors.clear();
+    return errors;
+}
+
+void GazeboControlClient::workerLoop()
+{
+    // Each worker has its own persistent connection so requests are handled in parallel
+    ros::ServiceClient client = ros::NodeHandle().serviceClient<gazebo_msgs::SpawnModel>(spawn_service, true);
+
+    while (true)
+    {
+        SpawnRequest request;
+        {
+            unique_lock<mutex> lock(queue_mutex);
+            while (!stopping && queued_requests.empty()) queue_not_empty.wait(lock);
+            if (stopping) return;
+
+            request = queued_requests.front();
+            queued_requests.pop_front();
+        }
+
+        QString error = callSpawn(client, request);
+
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            if (!error.isEmpty()) queued_errors += error + "\n";
+            requests_in_flight--;
+        }
+        queue_drained.notify_all();
+    }
+}
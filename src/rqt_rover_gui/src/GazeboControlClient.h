@@ -0,0 +1,79 @@
+/*!
+ * \brief   Long lived connection to the gazebo_ros model services. GazeboSimManager used to fork a
+ *          "rosrun gazebo_ros spawn_model" or "rosservice call" shell process for every model and wait for it,
+ *          which costs a process start, a ROS node start, and a master lookup per model.
+ *          This class keeps persistent service clients open instead. The synchronous calls use one set of clients
+ *          on the calling thread. queueSpawnModel() hands requests to a small pool of worker threads, each with
+ *          its own persistent spawn client, so many spawn requests are in flight at once. waitForQueued() blocks
+ *          until the queue is empty and reports the requests that failed.
+ * \class   GazeboControlClient
+ */
+
+#ifndef GazeboControlClient_H
+#define GazeboControlClient_H
+
+#include <ros/ros.h>
+#include <QString>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class GazeboControlClient
+{
+public:
+    GazeboControlClient(int worker_count = 4);
+    ~GazeboControlClient();
+
+    // Wait up to timeout seconds for gazebo to advertise its model services. Returns false if it did not.
+    bool waitForGazebo(double timeout);
+
+    // Synchronous requests. Return an empty string on success or the error reported by gazebo.
+    QString spawnModel(const string& model_name, const string& model_sdf, float x, float y, float z, float roll, float pitch, float yaw);
+    QString deleteModel(const string& model_name);
+    QString setModelState(const string& model_name, float x, float y, float z);
+    QString applyBodyWrench(const string& body_name, float x, float y, float z, float duration);
+
+    // Pipelined spawn. Returns immediately.
+    void queueSpawnModel(const string& model_name, const string& model_sdf, float x, float y, float z, float roll, float pitch, float yaw);
+
+    // Block until every queued spawn has been answered. Returns the errors, one per line, or an empty string.
+    QString waitForQueued();
+
+private:
+    struct SpawnRequest
+    {
+        string model_name;
+        string model_sdf;
+        float x, y, z;
+        float roll, pitch, yaw;
+    };
+
+    static QString callSpawn(ros::ServiceClient& client, const SpawnRequest& request);
+    void workerLoop();
+
+    ros::NodeHandle nh;
+
+    // Used by the synchronous calls. Created persistent so the TCP connection to gazebo is reused.
+    ros::ServiceClient spawn_client;
+    ros::ServiceClient delete_client;
+    ros::ServiceClient set_state_client;
+    ros::ServiceClient wrench_client;
+
+    // Work queue shared with the spawn workers
+    mutex queue_mutex;
+    condition_variable queue_not_empty;
+    condition_variable queue_drained;
+    deque<SpawnRequest> queued_requests;
+    int requests_in_flight;
+    QString queued_errors;
+    bool stopping;
+
+    vector<thread> workers;
+};
+
+#endif // GazeboControlClient_H
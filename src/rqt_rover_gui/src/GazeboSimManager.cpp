@@ -1,5 +1,11 @@
 #include "GazeboSimManager.h"
+#include <sim_layout/Arena.h>
+#include <sim_layout/Rovers.h>
+#include <sim_layout/Tags.h>
 #include <QDir>
+#include <QFile>
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <unistd.h>
 #include <iostream>
@@ -12,21 +18,30 @@ GazeboSimManager::GazeboSimManager()
     gazebo_client_process = NULL;
     gazebo_server_process = NULL;
     command_process = NULL;
+    control_client = NULL;
+    building_world = false;
 
     // Set the app_root by reading the evvironment variable SWARMATHON_APP_ROOT ideally set by the run.sh script.
     const char *name = "SWARMATHON_APP_ROOT";
     char *app_root_cstr;
     app_root_cstr = getenv(name);
     app_root = QString(app_root_cstr);
+
+    // Named after our pid so several GUIs on one machine do not overwrite each other's world files and logs
+    work_dir = QDir::tempPath() + "/swarmathon_gui_" + QString::number(getpid());
+    if (!QDir().mkpath(work_dir)) cout << "Could not create " << work_dir.toStdString() << endl;
 }
 
-QProcess* GazeboSimManager::startGazeboServer()
+// world_path defaults to the empty swarmathon world
+QProcess* GazeboSimManager::startGazeboServer(QString world_path)
 {
     if (gazebo_server_process != NULL) return gazebo_server_process;
 
+    if (world_path.isEmpty()) world_path = app_root + "/simulation/worlds/swarmathon.world";
+
     gazebo_server_process = new QProcess();
 
-    QString command = QString("rosrun gazebo_ros gzserver ") + app_root + "/simulation/worlds/swarmathon.world";
+    QString command = QString("rosrun gazebo_ros gzserver ") + world_path;
 
     gazebo_server_process->startDetached(command);
 
@@ -64,6 +79,9 @@ QString GazeboSimManager::stopGazeboServer()
     gazebo_server_process->close();
     cleanUpGazeboServer();
 
+    delete control_client;
+    control_client = NULL;
+
     QString return_msg = "<br><font color='yellow'>" + output + "</font><br>";
 
     return return_msg;
@@ -108,132 +126,157 @@ QString GazeboSimManager::stopGazeboClient()
 }
 
 
+// Returns immediately. roslaunch and each of the rover's nodes get SIGINT, and the supervisor reaps them in the
+// background. collectRoverNodeExits() reports how it ended.
 QString GazeboSimManager::stopRoverNode( QString rover_name )
 {
-    if (rover_processes.find(rover_name) == rover_processes.end()) return "Could not stop " + rover_name + " rover process since it does not exist.";
-
-    rover_processes[rover_name]->terminate();
-    rover_processes[rover_name]->waitForFinished();
-    rover_processes.erase(rover_name);
+    simulated_rovers.erase(rover_name.toStdString());
 
-    // Kill nodes
-    QString argument = "rosnode kill "+rover_name+"_MOBILITY";
-    QProcess sh;
-    sh.start("sh", QStringList() << "-c" << argument);
-    sh.waitForFinished();
-    QString output = sh.readAll();
-    sh.close();
+    if (!rover_supervisor.isRunning(rover_name.toStdString())) return "Could not stop " + rover_name + " rover process since it does not exist.";
 
-    argument = "rosnode kill "+rover_name+"_NAVSAT";
-    sh.start("sh", QStringList() << "-c" << argument);
-    sh.waitForFinished();
-    output += "<br>" + sh.readAll();
-    sh.close();
+    rover_supervisor.stop(rover_name.toStdString());
 
-    argument = "rosnode kill "+rover_name+"_TARGET";
-    sh.start("sh", QStringList() << "-c" << argument);
-    sh.waitForFinished();
-    output += "<br>" + sh.readAll();
-    sh.close();
+    return "Stopping rover process " + rover_name;
+}
 
-    argument = "rosnode kill "+rover_name+"_OBSTACLE";
-    sh.start("sh", QStringList() << "-c" << argument);
-    sh.waitForFinished();
-    output += "<br>" + sh.readAll();
-    sh.close();
+// Every rover uses the same launch file. The index and swarm size tell the rover which part of the search is its own.
+QString GazeboSimManager::startRoverNode(int rover_index, int swarm_size)
+{
+    QString rover_name = QString::fromStdString(sim_layout::roverName(rover_index));
+    QString argument = "roslaunch " + app_root + "/" + sim_layout::ROVER_LAUNCH_PATH + " name:=" + rover_name
+                     + " swarm_index:=" + QString::number(rover_index) + " swarm_size:=" + QString::number(swarm_size);
+    QString log_path = work_dir + "/" + rover_name + "_launch.log";
 
-    argument = "rosnode kill "+rover_name+"_EKF";
-    sh.start("sh", QStringList() << "-c" << argument);
-    sh.waitForFinished();
-    output += "<br>" + sh.readAll();
-    sh.close();
+    if (!rover_supervisor.start(rover_name.toStdString(), argument.toStdString(), log_path.toStdString()))
+    {
+        return "<font color='red'>Could not start the " + rover_name + " rover process</font>";
+    }
+    simulated_rovers[rover_name.toStdString()] = rover_index;
 
-    return output+"<br>rover process " + rover_name + " terminated along with <font color='green'>navsat, target, obstacle, and mobility</font> nodes";
+    return "rover process spawned";
 }
 
-QString GazeboSimManager::startRoverNode( QString rover_name )
+// Every launch file runs in its own process, so starting them all before waiting on any lets the rovers come up
+// concurrently. The caller waits for the rovers to announce themselves.
+QString GazeboSimManager::startRoverNodes(int swarm_size)
 {
-    QString argument = "roslaunch "+app_root+"/launch/"+rover_name+".launch name:="+rover_name;
+    for (int i = 0; i < swarm_size; i++) startRoverNode(i, swarm_size);
 
-    QProcess* rover_process = new QProcess();
+    return QString::number(swarm_size) + " rover processes spawned";
+}
 
-    rover_processes[rover_name] = rover_process;
+// False once every process of the rover's roslaunch has exited, e.g. because the launch file failed
+bool GazeboSimManager::isRoverNodeRunning(QString rover_name)
+{
+    return rover_supervisor.isRunning(rover_name.toStdString());
+}
 
-    rover_process->start("sh", QStringList() << "-c" << argument);
+int GazeboSimManager::runningRoverNodeCount()
+{
+    return rover_supervisor.runningCount();
+}
 
-    return "rover process spawned";
+set<string> GazeboSimManager::simulatedRoverNames()
+{
+    set<string> names;
+    for (map<string, int>::const_iterator it = simulated_rovers.begin(); it != simulated_rovers.end(); ++it) names.insert(it->first);
+    return names;
 }
 
-QString GazeboSimManager::addGroundPlane( QString ground_name )
+string GazeboSimManager::roverModelSDF(QString rover_name)
 {
-    QString argument = QString("rosrun gazebo_ros spawn_model -sdf -file ")+app_root+"/simulation/models/" + ground_name + "/model.sdf -model " + ground_name;
-    QProcess sh;
-    sh.start("sh", QStringList() << "-c" << argument);
+    map<string, int>::const_iterator it = simulated_rovers.find(rover_name.toStdString());
+    if (it == simulated_rovers.end()) return "";
 
-    sh.waitForFinished();
-    QByteArray output = sh.readAll();
-    sh.close();
+    return sim_layout::roverSDF(modelTemplate(sim_layout::ROVER_TEMPLATE_PATH), it->second);
+}
 
-    QString return_msg = "<br><font color='yellow'>" + output + "</font><br>";
+// One log line per rover process that has ended since the last call
+QString GazeboSimManager::collectRoverNodeExits()
+{
+    QString output;
 
-    return return_msg;
+    vector<RoverProcessSupervisor::ExitReport> exits = rover_supervisor.collectExits();
+    for (size_t i = 0; i < exits.size(); i++)
+    {
+        QString color = (exits[i].forced ? "red" : "yellow");
+        output += "<br><font color='" + color + "'>rover process " + QString::fromStdString(exits[i].rover_name) + " "
+                + QString::fromStdString(RoverProcessSupervisor::describe(exits[i])) + "</font>";
+    }
+
+    return output;
 }
 
-QString GazeboSimManager::addRover(QString rover_name, float x, float y, float z)
+void GazeboSimManager::beginWorld()
 {
-    float rover_clearance = 0.45; //meters
-    model_locations.insert(make_tuple(x, y, rover_clearance));
-
-    QString argument = "rosrun gazebo_ros spawn_model -sdf -file "+app_root+"/simulation/models/" + rover_name + "/model.sdf "
-               + "-model " + rover_name
-               + " -x " + QString::number(x)
-               + " -y " + QString::number(y)
-               + " -z " + QString::number(z);
-               + " -Y " + QString::number(M_PI);
+    building_world = true;
+    world_models.clear();
+}
 
-    QProcess sh;
-    sh.start("sh", QStringList() << "-c" << argument);
+// Writes the recorded models into a copy of the swarmathon world and returns the path of the new world file.
+// Returns an empty string if the file could not be written.
+QString GazeboSimManager::endWorld()
+{
+    building_world = false;
 
-    sh.waitForFinished();
-    QByteArray output = sh.readAll();
-    sh.close();
+    QString world_path = work_dir + "/swarmathon_generated.world";
+    string error;
+    bool written = sim_layout::writeWorldFile((app_root + "/simulation/worlds/swarmathon.world").toStdString(), world_models, world_path.toStdString(), error);
+    world_models.clear();
 
-    QString return_msg = "<br><font color='yellow'>" + output + "</font><br>";
+    if (!written)
+    {
+        cout << error << endl;
+        return "";
+    }
 
-    return return_msg;
+    return world_path;
 }
 
-QString GazeboSimManager::removeRover( QString rover_name)
+bool GazeboSimManager::waitForGazeboServer(double timeout)
 {
-    QString argument;
-    argument = "rosservice call gazebo/delete_model '{model_name: "+rover_name+"}'";
+    return client()->waitForGazebo(timeout);
+}
 
-    QProcess sh;
-    sh.start("sh", QStringList() << "-c" << argument);
+bool GazeboSimManager::recordWorldModel(QString model_name, QString unique_id, float x, float y, float z, float roll, float pitch, float yaw, const string& sdf)
+{
+    if (!building_world) return false;
 
-    sh.waitForFinished();
-    QByteArray output = sh.readAll();
-    sh.close();
+    sim_layout::WorldModel model = { model_name.toStdString(), unique_id.toStdString(), x, y, z, roll, pitch, yaw, sdf };
+    world_models.push_back(model);
+    return true;
+}
 
-    QString return_msg = "<br><font color='yellow'>" + output + "</font><br>";
+QString GazeboSimManager::addGroundPlane( QString ground_name )
+{
+    if (recordWorldModel(ground_name, ground_name, 0, 0, 0, 0, 0, 0)) return "";
 
-    return return_msg;
+    return formatResult("Added " + ground_name, client()->spawnModel(ground_name.toStdString(), modelSDF(ground_name), 0, 0, 0, 0, 0, 0));
 }
 
-QString GazeboSimManager::removeGroundPlane( QString ground_name )
+// Adds the rover at its starting position, generated from the rover SDF template
+QString GazeboSimManager::addRover(int rover_index)
 {
-    QString argument = "rosservice call gazebo/delete_model '{model_name: "+ground_name+"}'";
+    QString rover_name = QString::fromStdString(sim_layout::roverName(rover_index));
+    float x, y;
+    sim_layout::roverStartPosition(rover_index, x, y);
+    model_locations.insert(x, y, sim_layout::ROVER_CLEARANCE, rover_name);
 
-    QProcess sh;
-    sh.start("sh", QStringList() << "-c" << argument);
+    string sdf = sim_layout::roverSDF(modelTemplate(sim_layout::ROVER_TEMPLATE_PATH), rover_index);
+    if (recordWorldModel("swarmie", rover_name, x, y, 0, 0, 0, 0, sdf)) return "";
 
-    sh.waitForFinished();
-    QByteArray output = sh.readAll();
-    sh.close();
+    // The shell command this replaced never passed its yaw of M_PI on to spawn_model, so rovers have always started facing +x
+    return formatResult("Added " + rover_name, client()->spawnModel(rover_name.toStdString(), sdf, x, y, 0, 0, 0, 0));
+}
 
-    QString return_msg = "<br><font color='yellow'>" + output + "</font><br>";
+QString GazeboSimManager::removeRover( QString rover_name)
+{
+    return formatResult("Removed " + rover_name, client()->deleteModel(rover_name.toStdString()));
+}
 
-    return return_msg;
+QString GazeboSimManager::removeGroundPlane( QString ground_name )
+{
+    return formatResult("Removed " + ground_name, client()->deleteModel(ground_name.toStdString()));
 }
 
 QString GazeboSimManager::addModel(QString model_name, QString unique_id, float x, float y, float z, float clearance)
@@ -243,106 +286,109 @@ QString GazeboSimManager::addModel(QString model_name, QString unique_id, float
 
 QString GazeboSimManager::addModel(QString model_name, QString unique_id, float x, float y, float z, float roll, float pitch, float yaw, float clearance)
 {
-    model_locations.insert(make_tuple(x, y, clearance));
+    model_locations.insert(x, y, clearance, unique_id);
 
-    QString argument = "rosrun gazebo_ros spawn_model -sdf -file "+app_root+"/simulation/models/" + model_name + "/model.sdf "
-            + "-model " + unique_id
-            + " -x "    + QString::number(x)
-            + " -y "    + QString::number(y)
-            + " -z "    + QString::number(z)
-            + " -R "    + QString::number(roll)
-            + " -P "    + QString::number(pitch)
-            + " -Y "    + QString::number(yaw);
+    string sdf = generatedSDF(model_name, unique_id);
+    if (recordWorldModel(model_name, unique_id, x, y, z, roll, pitch, yaw, sdf)) return "";
 
-    QProcess sh;
-    sh.start("sh", QStringList() << "-c" << argument);
+    const string& spawn_sdf = sdf.empty() ? modelSDF(model_name) : sdf;
+    return formatResult("Added " + unique_id, client()->spawnModel(unique_id.toStdString(), spawn_sdf, x, y, z, roll, pitch, yaw));
+}
 
-    sh.waitForFinished();
-    QByteArray output = sh.readAll();
-    sh.close();
+void GazeboSimManager::queueModel(QString model_name, QString unique_id, float x, float y, float z, float clearance)
+{
+    queueModel(model_name, unique_id, x, y, z, 0, 0, 0, clearance);
+}
 
-    QString return_msg = "<br><font color='yellow'>" + output + "</font><br>";
+// The location is reserved immediately so placement can continue while gazebo is still spawning the model
+void GazeboSimManager::queueModel(QString model_name, QString unique_id, float x, float y, float z, float roll, float pitch, float yaw, float clearance)
+{
+    model_locations.insert(x, y, clearance, unique_id);
 
-    return return_msg;
+    string sdf = generatedSDF(model_name, unique_id);
+    if (recordWorldModel(model_name, unique_id, x, y, z, roll, pitch, yaw, sdf)) return;
+
+    const string& spawn_sdf = sdf.empty() ? modelSDF(model_name) : sdf;
+    client()->queueSpawnModel(unique_id.toStdString(), spawn_sdf, x, y, z, roll, pitch, yaw);
 }
 
-QString GazeboSimManager::removeModel( QString model_name )
+QString GazeboSimManager::waitForQueuedModels()
 {
-    QString argument = "rosservice call gazebo/delete_model '{model_name: "+model_name+"}'";
+    if (building_world) return "";
 
-    QProcess sh;
-    sh.start("sh", QStringList() << "-c" << argument);
+    return formatResult("Added queued models", client()->waitForQueued());
+}
 
-    sh.waitForFinished();
-    QByteArray output = sh.readAll();
-    sh.close();
+QString GazeboSimManager::removeModel( QString model_name )
+{
+    return formatResult("Removed " + model_name, client()->deleteModel(model_name.toStdString()));
+}
 
-    QString return_msg = "<br><font color='yellow'>" + output + "</font><br>";
+QString GazeboSimManager::moveRover(QString rover_name, float x, float y, float z)
+{
+    return formatResult("Moved " + rover_name, client()->setModelState(rover_name.toStdString(), x, y, z));
+}
 
-    return return_msg;
+QString GazeboSimManager::applyForceToRover(QString rover_name, float x, float y, float z, float duration)
+{
+    return formatResult("Pushed " + rover_name, client()->applyBodyWrench((rover_name + "::base_link").toStdString(), x, y, z, duration));
 }
 
-QString GazeboSimManager::moveRover(QString rover_name, float x, float y, float z)
+GazeboControlClient* GazeboSimManager::client()
 {
-            QString x_str = QString::number(x,'f',1);
-            QString y_str = QString::number(y,'f',1);
-            QString z_str = QString::number(z,'f',1);
-           // QString duration_str = QString::number(duration,'f',1);
+    if (control_client == NULL)
+    {
+        control_client = new GazeboControlClient();
 
-            QString argument = "rosservice call /gazebo/set_model_state '{model_state: { model_name: alpha, pose: { position: { x: 5, y: 0 ,z: 0 }, orientation: {x: 0, y: 0, z: 1, w: 1 } }, twist: { linear: {x: 0.0 , y: 0 ,z: 0 } , angular: { x: 0.0 , y: 0 , z: 0.0 } } , reference_frame: world } }'";
+        // Gazebo takes a few seconds to advertise its services after the server starts
+        if (!control_client->waitForGazebo(60)) cout << "Timed out waiting for the gazebo model services" << endl;
+    }
 
-            QProcess sh;
-            sh.start("sh", QStringList() << "-c" << argument);
+    return control_client;
+}
 
-            sh.waitForFinished();
-            QByteArray output = sh.readAll();
-            sh.close();
+const string& GazeboSimManager::modelSDF(QString model_name)
+{
+    map<QString, string>::iterator it = model_sdf_cache.find(model_name);
+    if (it != model_sdf_cache.end()) return it->second;
 
-            QString return_msg = "<br><font color='yellow'>" + output + "</font><br>";
+    ifstream model_file((app_root+"/simulation/models/" + model_name + "/model.sdf").toStdString().c_str());
+    stringstream sdf;
+    sdf << model_file.rdbuf();
 
-            return return_msg;
+    return model_sdf_cache[model_name] = sdf.str();
 }
 
-QString GazeboSimManager::applyForceToRover(QString rover_name, float x, float y, float z, float duration)
+const string& GazeboSimManager::modelTemplate(QString template_path)
 {
-            QString x_str = QString::number(x,'f',1);
-            QString y_str = QString::number(y,'f',1);
-            QString z_str = QString::number(z,'f',1);
-           // QString duration_str = QString::number(duration,'f',1);
+    map<QString, string>::iterator it = model_sdf_cache.find(template_path);
+    if (it != model_sdf_cache.end()) return it->second;
 
-            QString argument = "rosservice call /gazebo/apply_body_wrench '{ body_name: \"beta::base_link\", reference_frame: \"beta::base_link\", wrench: { force: { x: 1000, y: 0, z: 0 } }, start_time: 0, duration: 2 }'";
+    string sdf_template, error;
+    if (!sim_layout::loadModelTemplate((app_root + "/" + template_path).toStdString(), sdf_template, error)) cout << error << endl;
 
-            QProcess sh;
-            sh.start("sh", QStringList() << "-c" << argument);
+    return model_sdf_cache[template_path] = sdf_template;
+}
+
+string GazeboSimManager::generatedSDF(QString model_name, QString unique_id)
+{
+    if (!sim_layout::isTagModel(model_name.toStdString())) return "";
 
-            sh.waitForFinished();
-            QByteArray output = sh.readAll();
-            sh.close();
+    return sim_layout::tagSDF(modelTemplate(sim_layout::TAG_TEMPLATE_PATH), model_name.toStdString(), unique_id.toStdString());
+}
 
-            QString return_msg = "<br><font color='yellow'>" + output + "</font><br>";
+QString GazeboSimManager::formatResult(QString action, QString error)
+{
+    if (error.isEmpty()) return "<br><font color='yellow'>" + action + "</font><br>";
 
-            return return_msg;
+    error.replace("\n", "<br>");
+    return "<br><font color='red'>" + action + " failed: " + error + "</font><br>";
 }
 
 // Takes the center x and center y positions of an object along with its clearance and checks if any objects are within that area
 bool GazeboSimManager::isLocationOccupied(float x, float y, float clearance)
 {
-    set<tuple<float, float, float>>::iterator it;
-    for (it = model_locations.begin(); it != model_locations.end(); it++)
-    {
-        float used_x = get<0>(*it);
-        float used_y = get<1>(*it);
-        float used_clearance = get<2>(*it);
-
-        // Distance between circle centers
-        float d = sqrt(pow(x-used_x,2)+pow(y-used_y,2));
-        if (d < clearance+used_clearance)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return model_locations.overlapsAny(x, y, clearance);
 }
 
 bool GazeboSimManager::isGazeboServerRunning()
@@ -366,5 +412,6 @@ GazeboSimManager::~GazeboSimManager()
     delete gazebo_client_process;
     delete gazebo_server_process;
     delete command_process;
+    delete control_client;
 }
 
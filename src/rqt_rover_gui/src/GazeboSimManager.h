@@ -1,14 +1,17 @@
 /*!
- * \brief   This class is intended as an interface to the Gazebo Simulation. This is acheived
- *          by calling shell commands. A single gazebo process is created that lasts the life of the
- *          program. Other opererations on the simulation are performed by creating a shell process that only
- *          exists as long as the command takes to complete.
+ * \brief   Interface to the Gazebo simulation. The gazebo server and client run as processes that last as long
+ *          as the simulation. Models are spawned, moved and deleted through a GazeboControlClient, which keeps
+ *          persistent connections to the gazebo_ros services, so no process is started per model. queueModel()
+ *          pipelines spawns and waitForQueuedModels() collects the results. Model SDF files are read once and cached.
+ *          Between beginWorld() and endWorld() the manager is in world building mode: nothing is sent to gazebo,
+ *          the add functions record the models instead and endWorld() writes them all into one generated world
+ *          file, which startGazeboServer() then loads in one shot. Building a trial this way takes the same time
+ *          however many targets it has.
+ *          Each rover's roslaunch runs under a RoverProcessSupervisor, which tracks and stops the launch and all
+ *          of its nodes, so the GUI does not wait while a rover shuts down.
  * \author  Matthew Fricke
  * \date    November 11th 2015
- * \todo    A better solution would be to write a gazebo plugin that would pass on gazebo commands.
- *          Using a plugin would reduce the need to manage the shell processes spawned to manipulate models
- *          in the simulation.
- *          addModel can add any model including rovers and ground planes. The addRover and addGroundPlane
+ * \todo    addModel can add any model including rovers and ground planes. The addRover and addGroundPlane
  *          functions should just call addModel to avoid duplication of code.
  *          stopGazebo is buggy. It needs to be rewritten so gazebo is closed and the rover nodes shutdown
  *          without closing the GUI nodes.
@@ -20,10 +23,17 @@
 
 #include <QProcess>
 #include <QString>
+#include <QStringList>
 #include <map>
 #include <set>
 #include <string>
-#include <tuple>
+#include <vector>
+
+#include <shared_math/UniformGrid.h>
+#include <sim_layout/WorldFile.h>
+
+#include "GazeboControlClient.h"
+#include "RoverProcessSupervisor.h"
 
 using namespace std;
 
@@ -35,17 +45,29 @@ public:
 
     QString addGroundPlane( QString ground_name );
     QString removeGroundPlane( QString ground_name );
-    QString addRover(QString rover_name, float x, float y, float z);
+    QString addRover(int rover_index);
     QString removeRover(QString rover_name);
-    QString startRoverNode(QString rover_name);
+    QString startRoverNode(int rover_index, int swarm_size);
+    QString startRoverNodes(int swarm_size);
+    bool isRoverNodeRunning(QString rover_name);
+    int runningRoverNodeCount();
+    QString collectRoverNodeExits();
+    set<string> simulatedRoverNames(); // Started by startRoverNode() and not stopped since
+    string roverModelSDF(QString rover_name); // The SDF a simulated rover was built from, empty for any other rover
     QString stopRoverNode(QString rover_name);
-    QProcess* startGazeboServer();
+    QProcess* startGazeboServer(QString world_path = "");
     QProcess* startGazeboClient();
     QString stopGazeboServer();
     QString stopGazeboClient();
     QString removeModel( QString model_name );
     QString addModel(QString model_name, QString unique_id, float x, float y, float z, float clearance);
     QString addModel(QString model_name, QString unique_id, float x, float y, float z, float R, float P, float Y, float clearance);
+    void queueModel(QString model_name, QString unique_id, float x, float y, float z, float clearance);
+    void queueModel(QString model_name, QString unique_id, float x, float y, float z, float R, float P, float Y, float clearance);
+    QString waitForQueuedModels();
+    void beginWorld();
+    QString endWorld();
+    bool waitForGazeboServer(double timeout);
     QString moveRover(QString rover_name, float x, float y, float z);
     QString applyForceToRover(QString rover_name, float x, float y, float z, float duration);
     bool isLocationOccupied(float x, float y, float clearence);
@@ -55,15 +77,42 @@ public:
     void cleanUpGazeboServer();
 
 private:
+    // Creates the control client the first time it is needed and waits for gazebo to be ready
+    GazeboControlClient* client();
+
+    // Returns the contents of simulation/models/<model_name>/model.sdf, reading the file only the first time
+    const string& modelSDF(QString model_name);
+
+    // Returns a model SDF template (path relative to app_root), reading the file only the first time
+    const string& modelTemplate(QString template_path);
+
+    // Targets are generated from the tag template. Returns an empty string for every other model.
+    string generatedSDF(QString model_name, QString unique_id);
+
+    // In world building mode stores the model for the world file and returns true. A non empty sdf is written
+    // into the world instead of the model directory.
+    bool recordWorldModel(QString model_name, QString unique_id, float x, float y, float z, float roll, float pitch, float yaw, const string& sdf = "");
+
+    // Wraps the result of a gazebo request in the log message format used by the GUI
+    QString formatResult(QString action, QString error);
+
     QString app_root; // Path to the application root directory
+    QString work_dir; // <tmp>/swarmathon_gui_<pid>, holds the generated world file and the rover launch logs
+    GazeboControlClient* control_client; // Exists while the gazebo server is running
+    map<QString, string> model_sdf_cache; // Keyed by model name, or by path for templates
     QProcess* gazebo_server_process;
     QProcess* gazebo_client_process;
     QProcess* command_process;
-    map<QString, QProcess*> rover_processes;
+    RoverProcessSupervisor rover_supervisor; // Runs and stops each rover's roslaunch and its nodes
+    map<string, int> simulated_rovers; // Index of each rover started and not yet stopped, to tell them from physical rovers
+
+    // Models recorded between beginWorld() and endWorld()
+    bool building_world;
+    vector<sim_layout::WorldModel> world_models;
 
-    // Contains the positions of objects in the simulation and clearance value (the xy plane radius of the object)
-    // center x, center y, clearance
-    set< tuple<float, float, float> > model_locations;
+    // Contains the positions of objects in the simulation and clearance value (the xy plane radius of the object),
+    // keyed by the model's unique id. Hashed on a uniform grid so each occupancy test only looks at nearby objects.
+    shared_math::UniformGrid<QString> model_locations;
 };
 
 #endif // GazeboSimManager_H
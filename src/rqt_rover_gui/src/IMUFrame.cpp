@@ -4,6 +4,7 @@
 #include <QTimer>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 #include <IMUFrame.h>
 
@@ -14,29 +15,29 @@ IMUFrame::IMUFrame(QWidget *parent, Qt::WFlags flags) : QFrame(parent)
 {
     connect(this, SIGNAL(delayedUpdate()), this, SLOT(update()), Qt::QueuedConnection);
 
-        linear_acceleration = make_tuple(0,0,0); // ROS Geometry Messages Vector3: <x, y, z> -- Initialize to all 0s
-        angular_velocity = make_tuple(0,0,0); // ROS Geometry Messages Vector3: <x, y, z>    -- Initialize to all 0s
-        orientation = make_tuple(0,0,0,0); // ROS Geometry Messages Quaternion: <w, x, y, z>   -- Initialize to all 0s
+        linear_acceleration = Vec3(0,0,0); // ROS Geometry Messages Vector3: <x, y, z> -- Initialize to all 0s
+        angular_velocity = Vec3(0,0,0); // ROS Geometry Messages Vector3: <x, y, z>    -- Initialize to all 0s
+        orientation = Quat(0,0,0,0); // ROS Geometry Messages Quaternion: <w, x, y, z>   -- Initialize to all 0s
 
         // Make a test cube
         float center_x = this->width()/2;
         float center_y = this->height()/2;
         float width_of_square = 100;
 
-        cube[0] = make_tuple(width_of_square/2, -width_of_square/2, -width_of_square/2);
-        cube[1] = make_tuple(width_of_square/2, width_of_square/2, -width_of_square/2);
-        cube[2] = make_tuple(-width_of_square/2, width_of_square/2, -width_of_square/2);
-        cube[3] = make_tuple(-width_of_square/2, -width_of_square/2, -width_of_square/2);
-        cube[4] = make_tuple(width_of_square/2, -width_of_square/2, width_of_square/2);
-        cube[5] = make_tuple(width_of_square/2, width_of_square/2, width_of_square/2);
-        cube[6] = make_tuple(-width_of_square/2, width_of_square/2, width_of_square/2);
-        cube[7] = make_tuple(-width_of_square/2, -width_of_square/2, width_of_square/2);
+        cube[0] = Vec3(width_of_square/2, -width_of_square/2, -width_of_square/2);
+        cube[1] = Vec3(width_of_square/2, width_of_square/2, -width_of_square/2);
+        cube[2] = Vec3(-width_of_square/2, width_of_square/2, -width_of_square/2);
+        cube[3] = Vec3(-width_of_square/2, -width_of_square/2, -width_of_square/2);
+        cube[4] = Vec3(width_of_square/2, -width_of_square/2, width_of_square/2);
+        cube[5] = Vec3(width_of_square/2, width_of_square/2, width_of_square/2);
+        cube[6] = Vec3(-width_of_square/2, width_of_square/2, width_of_square/2);
+        cube[7] = Vec3(-width_of_square/2, -width_of_square/2, width_of_square/2);
 
-        line1_start = make_tuple(width_of_square/2, 0, 0);
-        line2_start = make_tuple(-width_of_square/2, 0, 0);
+        line1_start = Vec3(width_of_square/2, 0, 0);
+        line2_start = Vec3(-width_of_square/2, 0, 0);
 
-        line1_end = make_tuple(width_of_square, 0, 0);
-        line2_end = make_tuple(-width_of_square, 0, 0);
+        line1_end = Vec3(width_of_square, 0, 0);
+        line2_end = Vec3(-width_of_square, 0, 0);
 
         // Setup a timer to rotate the square every 1/10 second
 //        QTimer *timer = new QTimer(this);
@@ -56,20 +57,20 @@ IMUFrame::IMUFrame(QWidget *parent, Qt::WFlags flags) : QFrame(parent)
 
         float mag = sqrt(x*x+y*y+z*z);
 
-        tuple<float,float,float,float> quaternion = make_tuple(cos(angle/2),x*sin(angle/2)/mag,y*sin(angle/2)/mag,z*sin(angle/2)/mag);
+        Quat quaternion(cos(angle/2),x*sin(angle/2)/mag,y*sin(angle/2)/mag,z*sin(angle/2)/mag);
         for (int i = 0; i < 8; i++)
-        cube[i] = inverseRotateByQuaternion(cube[i], quaternion);
+        cube[i] = quaternion.inverseRotate(cube[i]);
 
         // Initialize the rotated_cube
         for (int i = 0; i < 8; i++)
         rotated_cube[i] = cube[i];
 
         // Rotate the lines coming out of the cube
-        line1_start = inverseRotateByQuaternion(line1_start, quaternion);
-        rotated_line2_start = inverseRotateByQuaternion(line2_start, quaternion);
+        line1_start = quaternion.inverseRotate(line1_start);
+        rotated_line2_start = quaternion.inverseRotate(line2_start);
 
-        line1_end = inverseRotateByQuaternion(line1_end, quaternion);
-        line2_end = inverseRotateByQuaternion(line2_end, quaternion);
+        line1_end = quaternion.inverseRotate(line1_end);
+        line2_end = quaternion.inverseRotate(line2_end);
 
         rotated_line1_start = line1_start;
         rotated_line2_start = line2_start;
@@ -78,6 +79,11 @@ IMUFrame::IMUFrame(QWidget *parent, Qt::WFlags flags) : QFrame(parent)
         rotated_line1_end = line1_end;
 
         frames = 0;
+
+        // Drain queued IMU samples and repaint at a fixed rate (30 Hz) no matter how fast messages arrive
+        draw_timer = new QTimer(this);
+        connect(draw_timer, SIGNAL(timeout()), this, SLOT(drawTimerEventHandler()));
+        draw_timer->start(1000/30);
 }
 
 
@@ -86,15 +92,53 @@ void IMUFrame::rotateTimerEventHandler()
     float center_x = this->width()/2;
     float center_y = this->height()/2;
 
-    tuple<float,float,float> axis_of_rotation = make_tuple(rand()%20,rand()%20,rand()%20);
+    Vec3 axis_of_rotation(rand()%20,rand()%20,rand()%20);
 
+    // Build the rotation once on the stack and apply it to every corner
+    Mat3 rotation = Mat3::fromAxisAngle(axis_of_rotation, M_PI/10);
     for (int i = 0; i < 8; i++)
-        cube[i] = rotateAboutAxis(cube[i], M_PI/10, axis_of_rotation);
+        cube[i] = rotation * cube[i];
 
 
     emit delayedUpdate();
 }
 
+void IMUFrame::drawTimerEventHandler()
+{
+    IMUSample sample;
+    bool received = false;
+
+    // Every sample goes into the history but only the newest one is used to position the cube
+    while (incoming_samples.pop(sample))
+    {
+        linear_acceleration_history.push(sample.linear_acceleration);
+        angular_velocity_history.push(sample.angular_velocity);
+        received = true;
+    }
+
+    if (!received) return;
+
+    linear_acceleration = sample.linear_acceleration;
+    angular_velocity = sample.angular_velocity;
+    setOrientation(sample.orientation);
+
+    update();
+}
+
+void IMUFrame::clear()
+{
+    // The GUI thread is the consumer, so it may drain the queue
+    IMUSample sample;
+    while (incoming_samples.pop(sample)) {}
+
+    linear_acceleration_history.clear();
+    angular_velocity_history.clear();
+    linear_acceleration = Vec3(0,0,0);
+    angular_velocity = Vec3(0,0,0);
+
+    update();
+}
+
 void IMUFrame::paintEvent(QPaintEvent* event)
 {
 
@@ -102,9 +146,21 @@ void IMUFrame::paintEvent(QPaintEvent* event)
     painter.setPen(Qt::white);
     painter.setRenderHint(QPainter::Antialiasing, true);
 
+    // The history plots share the bottom of the frame and the cube is centred in the space above them
+    int plot_height = 30;
+    QRect accel_plot_area(0, this->height()-2*plot_height-1, this->width()-1, plot_height);
+    QRect gyro_plot_area(0, this->height()-plot_height-1, this->width()-1, plot_height);
+
+    // Draw the plots first so the cube is drawn over them if they overlap
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    drawHistoryPlot(painter, linear_acceleration_history, accel_plot_area, 20.0f, "accel (m/s^2)");
+    drawHistoryPlot(painter, angular_velocity_history, gyro_plot_area, 5.0f, "gyro (rad/s)");
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(Qt::white);
+
     float center_x = this->width()/2;
 
-    float center_y = this->height()/2;
+    float center_y = (this->height()-2*plot_height)/2;
 
     // Track the frames per second for development purposes
     QString frames_per_second;
@@ -124,16 +180,16 @@ void IMUFrame::paintEvent(QPaintEvent* event)
     // end frames per second
 
     // Setup axes
-    tuple<float, float, float> axes_origin = make_tuple(0,0,0);
-    tuple<float, float, float> x_axis = make_tuple(this->width(),0,0);
-    tuple<float, float, float> y_axis = make_tuple(0,this->height(),0);
-    tuple<float, float, float> z_axis = make_tuple(0,0,this->width());
+    Vec3 axes_origin(0,0,0);
+    Vec3 x_axis(this->width(),0,0);
+    Vec3 y_axis(0,this->height(),0);
+    Vec3 z_axis(0,0,this->width());
 
 
     // Setup camera transform inputs
-     tuple<float, float, float> eye = make_tuple(0, 0, 1000);
-     tuple<float, float, float> camera_position = make_tuple(0, 0, 1080);
-     tuple<float, float, float> camera_angle = make_tuple(0, 0, M_PI/2);
+     Vec3 eye(0, 0, 1000);
+     Vec3 camera_position(0, 0, 1080);
+     Vec3 camera_angle(0, 0, M_PI/2);
 
     // Project 3D points into 2D
     QPoint projected_cube[8];
@@ -238,10 +294,8 @@ void IMUFrame::paintEvent(QPaintEvent* event)
     bottom_path.lineTo(projected_cube_bottom[0]);
 
     // Draw top and bottom faces with the nearest drawn on top (i.e. last)
-    tuple<float,float,float> top_corner = rotated_cube[0];
-    tuple<float,float,float> bottom_corner = rotated_cube[7];
-    float bottom_z = get<2>(bottom_corner);
-    float top_z = get<2>(top_corner);
+    float bottom_z = rotated_cube[7].z;
+    float top_z = rotated_cube[0].z;
 
     if (top_z < bottom_z)
     {
@@ -280,23 +334,19 @@ void IMUFrame::paintEvent(QPaintEvent* event)
 
 // Draw an acceleration arrow from the IMU accelerometer
 
-tuple<float, float, float> accel_start = make_tuple(0,0,0);
-tuple<float, float, float> accel_end = linear_acceleration;
+Vec3 accel_start(0,0,0);
+Vec3 accel_end = linear_acceleration;
 
-tuple<float, float, float> accel_end_head_x_left = accel_end;
-tuple<float, float, float> accel_end_head_x_right = accel_end;
-get<0>(accel_end_head_x_left) = get<0>(accel_end_head_x_left)-1;
-get<0>(accel_end_head_x_right) = get<0>(accel_end_head_x_right)+1;
-get<1>(accel_end_head_x_left) = get<1>(accel_end_head_x_left)+1;
-get<1>(accel_end_head_x_right) = get<1>(accel_end_head_x_right)+1;
+Vec3 accel_end_head_x_left = accel_end + Vec3(-1, 1, 0);
+Vec3 accel_end_head_x_right = accel_end + Vec3(1, 1, 0);
 
 // rotate about the x axis so z is up and down on the screen
-tuple<float,float,float> axis_of_rotation = make_tuple(0,1,0);
-accel_start = rotateAboutAxis(accel_start, M_PI/2, axis_of_rotation);
-accel_end = rotateAboutAxis(accel_end, M_PI/2, axis_of_rotation);
+Mat3 z_up = Mat3::fromAxisAngle(Vec3(0,1,0), M_PI/2);
+accel_start = z_up * accel_start;
+accel_end = z_up * accel_end;
 
-accel_end_head_x_left = rotateAboutAxis(accel_end_head_x_left, M_PI/2, axis_of_rotation);
-accel_end_head_x_right = rotateAboutAxis(accel_end_head_x_right, M_PI/2, axis_of_rotation);
+accel_end_head_x_left = z_up * accel_end_head_x_left;
+accel_end_head_x_right = z_up * accel_end_head_x_right;
 
 QPoint projected_accel_start = cameraTransform(accel_start, eye, camera_position, camera_angle);
 QPoint projected_accel_end = cameraTransform(accel_end, eye, camera_position, camera_angle);
@@ -334,184 +384,117 @@ painter.drawLine( QPoint(projected_accel_end_head_x_right.x()+center_x, projecte
 
 }
 
-void IMUFrame::setLinearAcceleration(float x, float y, float z)
+void IMUFrame::addSample(const IMUSample& sample)
 {
-    linear_acceleration = make_tuple(x, y, z);
-    emit delayedUpdate();
+    // If the GUI thread stalls the ring fills up and new samples are dropped rather than blocking ROS
+    incoming_samples.push(sample);
 }
 
-void IMUFrame::setAngularVelocity(float x, float y, float z)
+void IMUFrame::drawHistoryPlot(QPainter& painter, const IMUHistory& history, const QRect& area, float range, const QString& label)
 {
-    angular_velocity = make_tuple(x, y, z);
-    emit delayedUpdate();
+    painter.setPen(QColor(80, 80, 80));
+    painter.drawRect(area);
+
+    int zero_y = area.top() + area.height()/2;
+    painter.drawLine(area.left(), zero_y, area.right(), zero_y);
+
+    QFontMetrics fm(painter.font());
+    painter.setPen(Qt::white);
+    painter.drawText(area.left()+2, area.top()+fm.ascent(), label);
+
+    int n = history.size();
+    int columns = area.width()-1;
+    if (n == 0 || columns <= 0) return;
+
+    // Fixed number of samples per pixel column so the plot scrolls at a constant rate.
+    // The newest sample is at the right edge.
+    int samples_per_column = max<int>(1, IMUHistory::capacity() / columns);
+    float scale = (area.height()/2 - 1) / range;
+
+    // Colorblind friendly colors for x, y and z
+    QColor axis_colors[3] = { QColor(255, 65, 30), QColor(17, 192, 131), QColor(60, 140, 255) };
+    QVector<QLine> lines[3];
+
+    for (int column = 0; column < columns; column++)
+    {
+        int end = n - column*samples_per_column;
+        if (end <= 0) break;
+
+        // Include the last sample of the previous column so neighbouring bars join up
+        int begin = max(0, end - samples_per_column - 1);
+
+        Vec3 min_value = history[begin];
+        Vec3 max_value = history[begin];
+        for (int i = begin+1; i < end; i++)
+        {
+            const Vec3& v = history[i];
+            min_value = Vec3(min(min_value.x, v.x), min(min_value.y, v.y), min(min_value.z, v.z));
+            max_value = Vec3(max(max_value.x, v.x), max(max_value.y, v.y), max(max_value.z, v.z));
+        }
+
+        float mins[3] = { min_value.x, min_value.y, min_value.z };
+        float maxs[3] = { max_value.x, max_value.y, max_value.z };
+
+        int x = area.right() - 1 - column;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            int top = zero_y - maxs[axis]*scale;
+            int bottom = zero_y - mins[axis]*scale;
+            top = max(area.top()+1, min(area.bottom()-1, top));
+            bottom = max(area.top()+1, min(area.bottom()-1, bottom));
+            lines[axis].append(QLine(x, top, x, bottom));
+        }
+    }
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        painter.setPen(axis_colors[axis]);
+        painter.drawLines(lines[axis]);
+    }
 }
 
-void IMUFrame::setOrientation(float w, float x, float y, float z)
+void IMUFrame::setOrientation(const Quat& orientation)
 {
     // Quaternions: A quaternion represents two things.  It has an x, y, and z component, which represents the axis about which a rotation will occur.
     // It also has a w component, which represents the amount of rotation which will occur about this axis. The rotationMatrix() function can use this representation
     // to rotate the object properly
 
-//    orientation = make_tuple(w, x, y, z);
-//    float angle_of_rotation = get<0>(orientation);
-//    tuple<float, float, float> axis_of_rotation = make_tuple(get<1>(orientation), get<2>(orientation), get<3>(orientation));
-
-//    for (int i = 0; i < 8; i++)
-//        rotated_cube[i] = rotateAboutAxis(cube[i], angle_of_rotation, axis_of_rotation);
-
-    tuple<float,float,float,float> quaternion = make_tuple(w,x,y,z);
+    this->orientation = orientation;
 
     for (int i = 0; i < 8; i++)
-        rotated_cube[i] = inverseRotateByQuaternion(cube[i], quaternion);
-
-    rotated_line1_start = inverseRotateByQuaternion(line1_start, quaternion);
-    rotated_line2_start = inverseRotateByQuaternion(line2_start, quaternion);
-
-    rotated_line1_end = inverseRotateByQuaternion(line1_end, quaternion);
-    rotated_line2_end = inverseRotateByQuaternion(line2_end, quaternion);
+        rotated_cube[i] = orientation.inverseRotate(cube[i]);
 
+    rotated_line1_start = orientation.inverseRotate(line1_start);
+    rotated_line2_start = orientation.inverseRotate(line2_start);
 
-    emit delayedUpdate();
+    rotated_line1_end = orientation.inverseRotate(line1_end);
+    rotated_line2_end = orientation.inverseRotate(line2_end);
 }
 
-QPoint IMUFrame::cameraTransform( tuple<float, float, float> point_3D, tuple<float, float, float> eye, tuple<float, float, float> camera_position, tuple<float, float, float> camera_angle )
+QPoint IMUFrame::cameraTransform( const Vec3& point_3D, const Vec3& eye, const Vec3& camera_position, const Vec3& camera_angle )
 {
-    tuple<float, float, float> a = point_3D;
-    tuple<float, float, float> cam = camera_position;
-    tuple<float, float, float> theta = camera_angle;
-
-
-    float x = (get<0>(a)-get<0>(cam));
-    float y = (get<1>(a)-get<1>(cam));
-    float z = (get<2>(a)-get<2>(cam));
-    float c_x = cos(get<0>(theta));
-    float c_y = cos(get<1>(theta));
-    float c_z = cos(get<2>(theta));
-    float s_x = sin(get<0>(theta));
-    float s_y = sin(get<1>(theta));
-    float s_z = sin(get<2>(theta));
-    float e_x = get<0>(eye);
-    float e_y = get<1>(eye);
-    float e_z = get<2>(eye);
+    Vec3 a = point_3D - camera_position;
+    const Vec3& theta = camera_angle;
+
+    float x = a.x;
+    float y = a.y;
+    float z = a.z;
+    float c_x = cos(theta.x);
+    float c_y = cos(theta.y);
+    float c_z = cos(theta.z);
+    float s_x = sin(theta.x);
+    float s_y = sin(theta.y);
+    float s_z = sin(theta.z);
 
     float d_x = c_y*(s_z*y+c_z*x)-s_y*z;
     float d_y = s_x*(c_y*z+s_y*(s_z*y+c_z*x))+c_x*(c_z*y-s_z*x);
     float d_z = c_x*(c_y*z+s_y*(s_z*y+c_z*x))-s_x*(c_z*y-s_z*x);
 
-    float b_x = (e_z/d_z)*d_x-e_x;
-    float b_y = (e_z/d_z)*d_y-e_y;
+    float b_x = (eye.z/d_z)*d_x-eye.x;
+    float b_y = (eye.z/d_z)*d_y-eye.y;
 
     return QPoint(b_x, b_y);
 }
 
-
-float** IMUFrame::setUpRotationMatrix(float angle, tuple<float, float, float> axis_of_rotation) // angle in radians
-{
-    float u = get<0>(axis_of_rotation);
-    float v = get<1>(axis_of_rotation);
-    float w = get<2>(axis_of_rotation);
-
-    float L = (u*u + v*v + w*w);
-    float u2 = u*u;
-    float v2 = v*v;
-    float w2 = w*w;
-
-    float** rotation_matrix = new float*[4];
-    for (int i = 0; i < 4; i++)
-        rotation_matrix[i] = new float[4];
-
-    rotation_matrix[0][0] = (u2 + (v2 + w2) * cos(angle)) / L;
-    rotation_matrix[0][1] = (u * v * (1 - cos(angle)) - w * sqrt(L) * sin(angle)) / L;
-    rotation_matrix[0][2] = (u * w * (1 - cos(angle)) + v * sqrt(L) * sin(angle)) / L;
-    rotation_matrix[0][3] = 0.0;
-
-    rotation_matrix[1][0] = (u * v * (1 - cos(angle)) + w * sqrt(L) * sin(angle)) / L;
-    rotation_matrix[1][1] = (v2 + (u2 + w2) * cos(angle)) / L;
-    rotation_matrix[1][2] = (v * w * (1 - cos(angle)) - u * sqrt(L) * sin(angle)) / L;
-    rotation_matrix[1][3] = 0.0;
-
-    rotation_matrix[2][0] = (u * w * (1 - cos(angle)) - v * sqrt(L) * sin(angle)) / L;
-    rotation_matrix[2][1] = (v * w * (1 - cos(angle)) + u * sqrt(L) * sin(angle)) / L;
-    rotation_matrix[2][2] = (w2 + (u2 + v2) * cos(angle)) / L;
-    rotation_matrix[2][3] = 0.0;
-
-    rotation_matrix[3][0] = 0.0;
-    rotation_matrix[3][1] = 0.0;
-    rotation_matrix[3][2] = 0.0;
-    rotation_matrix[3][3] = 1.0;
-
-    return rotation_matrix;
-}
-
-    tuple<float, float, float> IMUFrame::rotateAboutAxis(tuple<float, float, float> point, float angle, tuple<float, float, float> axis_of_rotation )
-    {
-       float** rotation_matrix = setUpRotationMatrix(angle, axis_of_rotation);
-
-       tuple<float, float, float> rotated_point;
-
-       float position_vector[4] = {0.0, 0.0, 0.0, 0.0};
-       float rotated_position_vector[4] = {0.0, 0.0, 0.0, 0.0};
-
-       position_vector[0] = get<0>(point);
-       position_vector[1] = get<1>(point);
-       position_vector[2] = get<2>(point);
-       position_vector[3] = 1.0;
-
-       // Multiply the position vector by the rotation matrix
-        for(int i = 0; i < 4; i++ )
-            for(int k = 0; k < 4; k++)
-                rotated_position_vector[i] += rotation_matrix[i][k] * position_vector[k];
-
-      // Clean up the rotation matrix
-      for (int i = 0; i < 4; i++) delete [] rotation_matrix[i];
-      delete [] rotation_matrix;
-
-      get<0>(rotated_point) = rotated_position_vector[0];
-      get<1>(rotated_point) = rotated_position_vector[1];
-      get<2>(rotated_point) = rotated_position_vector[2];
-
-      return rotated_point;
-
-    }
-
-    tuple<float, float, float> IMUFrame::rotateByQuaternion(tuple<float, float, float> v, tuple<float, float, float, float>  quaternion)
-    {
-
-        tuple<float, float, float> rotated_point;
-
-        // Extract the vector part of the quaternion
-        //float magnitude = sqrt(get<1>(quaternion)*get<1>(quaternion)+get<2>(quaternion)*get<2>(quaternion)+get<3>(quaternion)*get<3>(quaternion));
-
-        //cout << "Magnitude: " << magnitude << endl;
-
-        //tuple<float, float, float> u = make_tuple(get<1>(quaternion)/magnitude, get<2>(quaternion)/magnitude, get<3>(quaternion)/magnitude);
-        tuple<float, float, float> u = make_tuple(get<1>(quaternion), get<2>(quaternion), get<3>(quaternion));
-
-        // Extract the scalar part of the quaternion
-        float s = get<0>(quaternion);
-
-        // Calculate rotated point
-        // dot prod of u and v
-        float dot_uv = get<0>(u)*get<0>(v)+get<1>(u)*get<1>(v)+get<2>(u)*get<2>(v);
-
-        float dot_uu = get<0>(u)*get<0>(u)+get<1>(u)*get<1>(u)+get<2>(u)*get<2>(u);
-
-        tuple<float, float, float> cross_uv = make_tuple(get<1>(u)*get<2>(v)-get<1>(v)*get<2>(u),
-                                                         get<0>(v)*get<2>(u)-get<0>(u)*get<2>(v),
-                                                         get<0>(u)*get<1>(v)-get<0>(v)*get<1>(u));
-
-        rotated_point = make_tuple(2.0f * dot_uv * get<0>(u) + (s*s - dot_uu) * get<0>(v) + 2.0f * s * get<0>(cross_uv),
-                                   2.0f * dot_uv * get<1>(u) + (s*s - dot_uu) * get<1>(v) + 2.0f * s * get<1>(cross_uv),
-                                   2.0f * dot_uv * get<2>(u) + (s*s - dot_uu) * get<2>(v) + 2.0f * s * get<2>(cross_uv));
-
-        return rotated_point;
-    }
-
-    tuple<float, float, float> IMUFrame::inverseRotateByQuaternion(tuple<float, float, float> v, tuple<float, float, float, float>  quaternion)
-    {
-        // Make the vector component of the quaternion negative. This reverses the rotation.
-        return rotateByQuaternion(v,  make_tuple(get<0>(quaternion), -get<1>(quaternion), -get<2>(quaternion), -get<3>(quaternion)));
-    }
-
 }
 #endif
@@ -6,6 +6,10 @@
  *          The cube is viewed from the top down. The cube is positioned according to the IMU orientation data.
  *          For example, if the rover flips over, the red side will be closest to the observer.
  *          Accelerometer data is shown as a 3D vector projected into 2D space pointing towards the sum of the accelerations in 3D space.
+ *          Below the cube two scrolling plots show the history of the linear acceleration and angular velocity.
+ *          IMU messages can arrive much faster than the screen refreshes, so samples are queued in a lock-free
+ *          ring buffer by the ROS thread and the frame drains it and repaints at a fixed rate. The plots keep
+ *          the min and max of every sample that falls in a pixel column so short spikes are still visible.
  * \author  Matthew Fricke
  * \date    November 11th 2015
  * \todo
@@ -16,6 +20,7 @@
 #define IMUFRAME_H
 
 #include <QTime> // for frame rate
+#include <QTimer>
 #include <QFrame>
 #include <QImage>
 #include <QMutex>
@@ -23,19 +28,39 @@
 #include <vector>
 #include <utility> // For STL pair
 
+#include <shared_math/Vec3.h>
+#include <shared_math/Quat.h>
+#include <shared_math/Mat3.h>
+
+#include "RingBuffer.h"
+
 using namespace std;
+using shared_math::Vec3;
+using shared_math::Quat;
+using shared_math::Mat3;
 
 namespace rqt_rover_gui
 {
 
+// One IMU message as queued between the ROS thread and the GUI thread
+struct IMUSample
+{
+    Vec3 linear_acceleration; // ROS Geometry Messages Vector3: <x, y, z>
+    Vec3 angular_velocity; // ROS Geometry Messages Vector3: <x, y, z>
+    Quat orientation; // ROS Geometry Messages Quaternion: <w, x, y, z>
+};
+
 class IMUFrame : public QFrame
 {
     Q_OBJECT
 public:
     IMUFrame(QWidget *parent, Qt::WFlags = 0);
-    void setLinearAcceleration(float x, float y, float z);
-    void setAngularVelocity(float x, float y, float z);
-    void setOrientation(float w, float x, float y, float z);
+
+    // Safe to call from the ROS callback thread. Does not trigger a repaint.
+    void addSample(const IMUSample& sample);
+
+    // GUI thread only. Forgets the queued samples and the plotted history, e.g. when another rover is selected.
+    void clear();
 
 signals:
 
@@ -43,38 +68,46 @@ signals:
 
 public slots:
     void rotateTimerEventHandler();
-
+    void drawTimerEventHandler();
 
 protected:
 
     void paintEvent(QPaintEvent *event);
 
 private:
-    QPoint cameraTransform( tuple<float, float, float> point_3D, tuple<float, float, float> eye, tuple<float, float, float> camera_position, tuple<float, float, float> camera_angle );
-    tuple<float, float, float> rotateByQuaternion( tuple<float, float, float> point,  tuple<float, float, float, float> quaternion);
-    tuple<float, float, float> inverseRotateByQuaternion( tuple<float, float, float> point,  tuple<float, float, float, float> quaternion);
-    tuple<float, float, float> rotateAboutAxis(tuple<float, float, float> point, float angle,  tuple<float, float, float> axis_of_rotation);
-    float** setUpRotationMatrix(float angle, tuple<float, float, float> axis_rotation); // angle in radians   
+    typedef HistoryBuffer<Vec3, 1024> IMUHistory;
+
+    void setOrientation(const Quat& orientation);
+    void drawHistoryPlot(QPainter& painter, const IMUHistory& history, const QRect& area, float range, const QString& label);
+    QPoint cameraTransform( const Vec3& point_3D, const Vec3& eye, const Vec3& camera_position, const Vec3& camera_angle );
+
+    // Written by the ROS thread, read by the draw timer
+    SPSCRingBuffer<IMUSample, 1024> incoming_samples;
+
+    // Only touched by the GUI thread
+    IMUHistory linear_acceleration_history;
+    IMUHistory angular_velocity_history;
+    QTimer* draw_timer;
 
-    tuple<float, float, float> linear_acceleration; // ROS Geometry Messages Vector3: <x, y, z>
-    tuple<float, float, float> angular_velocity; // ROS Geometry Messages Vector3: <x, y, z>
-    tuple<float, float, float, float> orientation; // ROS Geometry Messages Quaternion: <w, x, y, z>
+    Vec3 linear_acceleration; // ROS Geometry Messages Vector3: <x, y, z>
+    Vec3 angular_velocity; // ROS Geometry Messages Vector3: <x, y, z>
+    Quat orientation; // ROS Geometry Messages Quaternion: <w, x, y, z>
 
     // Test points to render
-    tuple<float, float, float> cube[8];
-    tuple<float, float, float> rotated_cube[8];
+    Vec3 cube[8];
+    Vec3 rotated_cube[8];
 
-    tuple<float, float, float> line1_start;
-    tuple<float, float, float> line1_end;
+    Vec3 line1_start;
+    Vec3 line1_end;
 
-    tuple<float, float, float> line2_start;
-    tuple<float, float, float> line2_end;
+    Vec3 line2_start;
+    Vec3 line2_end;
 
-    tuple<float, float, float> rotated_line1_start;
-    tuple<float, float, float> rotated_line1_end;
+    Vec3 rotated_line1_start;
+    Vec3 rotated_line1_end;
 
-    tuple<float, float, float> rotated_line2_start;
-    tuple<float, float, float> rotated_line2_end;
+    Vec3 rotated_line2_start;
+    Vec3 rotated_line2_end;
 
     QTime frame_rate_timer;
     int frames;
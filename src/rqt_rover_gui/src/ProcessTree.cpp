@@ -0,0 +1,115 @@
+#include "ProcessTree.h"
+#include <dirent.h>
+#include <signal.h>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+
+ProcessTree::ProcessTree()
+{
+    DIR* proc = opendir("/proc");
+    if (proc == NULL) return;
+
+    struct dirent* item;
+    while ((item = readdir(proc)) != NULL)
+    {
+        pid_t pid = atoi(item->d_name);
+        if (pid <= 0) continue;
+
+        Entry entry;
+        if (readStat(pid, entry)) processes[pid] = entry;
+    }
+
+    closedir(proc);
+}
+
+void ProcessTree::collect(pid_t group, vector<TrackedProcess>& tracked) const
+{
+    set<pid_t> found;
+    for (map<pid_t, Entry>::const_iterator it = processes.begin(); it != processes.end(); ++it)
+        if (it->second.group == group) found.insert(it->first);
+
+    // Keep adding the children of what was found until nothing new turns up
+    bool added = true;
+    while (added)
+    {
+        added = false;
+        for (map<pid_t, Entry>::const_iterator it = processes.begin(); it != processes.end(); ++it)
+        {
+            if (found.count(it->second.parent) > 0 && found.insert(it->first).second) added = true;
+        }
+    }
+
+    for (set<pid_t>::const_iterator pid = found.begin(); pid != found.end(); ++pid)
+    {
+        const Entry& entry = processes.find(*pid)->second;
+        if (entry.zombie) continue;
+
+        bool known = false;
+        for (size_t i = 0; i < tracked.size() && !known; i++)
+            known = tracked[i].pid == *pid && tracked[i].start_time == entry.start_time;
+
+        if (!known)
+        {
+            TrackedProcess process = { *pid, entry.group, entry.start_time };
+            tracked.push_back(process);
+        }
+    }
+}
+
+void ProcessTree::prune(vector<TrackedProcess>& tracked)
+{
+    for (size_t i = 0; i < tracked.size(); )
+    {
+        Entry entry;
+        bool alive = readStat(tracked[i].pid, entry) && entry.start_time == tracked[i].start_time && !entry.zombie;
+
+        if (alive)
+        {
+            i++;
+        }
+        else
+        {
+            tracked[i] = tracked.back();
+            tracked.pop_back();
+        }
+    }
+}
+
+void ProcessTree::signal(const vector<TrackedProcess>& tracked, int sig)
+{
+    for (size_t i = 0; i < tracked.size(); i++)
+    {
+        if (tracked[i].group == tracked[i].pid) kill(-tracked[i].pid, sig);
+        else kill(tracked[i].pid, sig);
+    }
+}
+
+bool ProcessTree::readStat(pid_t pid, Entry& entry)
+{
+    ostringstream path;
+    path << "/proc/" << pid << "/stat";
+
+    ifstream file(path.str().c_str());
+    string line;
+    if (!getline(file, line)) return false;
+
+    // The command name is in parentheses and may itself contain spaces and parentheses
+    size_t name_end = line.rfind(')');
+    if (name_end == string::npos) return false;
+
+    // Fields after the name: state ppid pgrp session tty_nr tpgid flags minflt cminflt majflt cmajflt
+    // utime stime cutime cstime priority nice num_threads itrealvalue starttime
+    istringstream fields(line.substr(name_end + 1));
+    char state;
+    string skip;
+    fields >> state >> entry.parent >> entry.group;
+    for (int i = 0; i < 16; i++) fields >> skip;
+    fields >> entry.start_time;
+    if (!fields) return false;
+
+    entry.zombie = (state == 'Z' || state == 'X');
+    return true;
+}
@@ -0,0 +1,59 @@
+/*!
+ * \brief   Finds and signals the processes started under a process group, including the ones that left it.
+ *          roslaunch starts every node with setsid(), so each node runs in its own session and process group
+ *          and a signal to the group roslaunch runs in never reaches it. A ProcessTree is read from /proc and
+ *          collect() follows parent links from the members of a group down to every descendant, wherever they
+ *          moved. Processes are remembered by pid and start time, so a pid that is reused after the process
+ *          exits is not mistaken for it.
+ *          Descendants can only be found while their parent is alive. Once roslaunch exits its nodes are
+ *          reparented to init, so collect() has to be called before that, e.g. regularly while the launch runs.
+ * \class   ProcessTree
+ */
+
+#ifndef ProcessTree_H
+#define ProcessTree_H
+
+#include <sys/types.h>
+#include <map>
+#include <vector>
+
+using namespace std;
+
+class ProcessTree
+{
+public:
+    struct TrackedProcess
+    {
+        pid_t pid;
+        pid_t group;                    // The node's own group if it called setsid()
+        unsigned long long start_time;  // Clock ticks after boot, from /proc/<pid>/stat
+    };
+
+    // Reads every process from /proc
+    ProcessTree();
+
+    // Adds every process in group, and every descendant of those, to tracked if it is not there already
+    void collect(pid_t group, vector<TrackedProcess>& tracked) const;
+
+    // Removes the processes that have exited or are zombies waiting to be reaped
+    static void prune(vector<TrackedProcess>& tracked);
+
+    // Sends sig to the group of each tracked process that leads its own group, and to the others by pid
+    static void signal(const vector<TrackedProcess>& tracked, int sig);
+
+private:
+    struct Entry
+    {
+        pid_t parent;
+        pid_t group;
+        unsigned long long start_time;
+        bool zombie;
+    };
+
+    // False if the process does not exist
+    static bool readStat(pid_t pid, Entry& entry);
+
+    map<pid_t, Entry> processes;
+};
+
+#endif // ProcessTree_H
@@ -0,0 +1,103 @@
+/*!
+ * \brief   Fixed size ring buffers used to move high rate sensor data from the ROS callback thread
+ *          to the QT GUI thread without locking.
+ *
+ *          SPSCRingBuffer is a single producer, single consumer queue. The ROS callback pushes and the
+ *          GUI timer pops. Neither side ever blocks: if the GUI falls behind by more than Capacity samples
+ *          the newest samples are dropped and counted.
+ *
+ *          HistoryBuffer is only touched by the GUI thread. It keeps the last Capacity values and
+ *          overwrites the oldest one, so the frames can plot a scrolling history.
+ *
+ *          Capacity must be a power of two so indices wrap with a mask instead of a modulo.
+ * \class   SPSCRingBuffer, HistoryBuffer
+ */
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace rqt_rover_gui
+{
+
+template <typename T, size_t Capacity>
+class SPSCRingBuffer
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SPSCRingBuffer capacity must be a power of two");
+
+public:
+    SPSCRingBuffer() : head(0), tail(0), dropped(0) {}
+
+    // Producer side. Returns false and drops the value if the buffer is full.
+    bool push(const T& value)
+    {
+        size_t current_tail = tail.load(std::memory_order_relaxed);
+        if (current_tail - head.load(std::memory_order_acquire) == Capacity)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        buffer[current_tail & (Capacity - 1)] = value;
+        tail.store(current_tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if there was nothing to read.
+    bool pop(T& value)
+    {
+        size_t current_head = head.load(std::memory_order_relaxed);
+        if (current_head == tail.load(std::memory_order_acquire)) return false;
+
+        value = buffer[current_head & (Capacity - 1)];
+        head.store(current_head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Number of values the producer had to throw away because the consumer was too slow
+    size_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    T buffer[Capacity];
+
+    // Monotonic counters. Only the low bits are used to index the buffer.
+    std::atomic<size_t> head; // written by the consumer
+    std::atomic<size_t> tail; // written by the producer
+    std::atomic<size_t> dropped;
+};
+
+template <typename T, size_t Capacity>
+class HistoryBuffer
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "HistoryBuffer capacity must be a power of two");
+
+public:
+    HistoryBuffer() : next(0), count(0) {}
+
+    void push(const T& value)
+    {
+        buffer[next] = value;
+        next = (next + 1) & (Capacity - 1);
+        if (count < Capacity) count++;
+    }
+
+    // Index 0 is the oldest stored value, size()-1 the newest
+    const T& operator[](size_t i) const { return buffer[(next - count + i) & (Capacity - 1)]; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { next = 0; count = 0; }
+
+    static size_t capacity() { return Capacity; }
+
+private:
+    T buffer[Capacity];
+    size_t next;
+    size_t count;
+};
+
+}
+
+#endif // RINGBUFFER_H
@@ -0,0 +1,105 @@
+#include "RoverConnection.h"
+#include <rover_gui_plugin.h>
+#include <std_msgs/Int16.h>
+#include <std_msgs/UInt8.h>
+#include <QMutexLocker>
+
+using namespace std;
+
+namespace rqt_rover_gui
+{
+
+RoverConnection::RoverConnection(const string& rover_name, ros::NodeHandle& nh, RoverGUIPlugin* plugin, QListWidget* rover_list)
+{
+    this->rover_name = rover_name;
+    this->rover_list = rover_list;
+
+    //Set up publishers
+    control_mode_publisher = nh.advertise<std_msgs::UInt8>("/"+rover_name+"/mode", 10, true); // last argument sets latch to true
+    target_pick_up_publisher = nh.advertise<std_msgs::Int16>("/"+rover_name+"/targetPickUpValue", 10, true);
+    target_drop_off_publisher = nh.advertise<std_msgs::Int16>("/"+rover_name+"/targetDropOffValue", 10, true);
+
+    //Set up subscribers
+    status_subscriber = nh.subscribe("/"+rover_name+"/status", 10, &RoverConnection::statusEventHandler, this);
+    obstacle_subscriber = nh.subscribe("/"+rover_name+"/obstacle", 10, &RoverGUIPlugin::obstacleEventHandler, plugin);
+    encoder_subscriber = nh.subscribe("/"+rover_name+"/odom/", 10, &RoverGUIPlugin::encoderEventHandler, plugin);
+    ekf_subscriber = nh.subscribe("/"+rover_name+"/odom/ekf", 10, &RoverGUIPlugin::EKFEventHandler, plugin);
+    gps_subscriber = nh.subscribe("/"+rover_name+"/odom/navsat", 10, &RoverGUIPlugin::GPSEventHandler, plugin);
+    target_pick_up_subscriber = nh.subscribe("/"+rover_name+"/targetPickUpImage", 10, &RoverGUIPlugin::targetPickUpEventHandler, plugin);
+    target_drop_off_subscriber = nh.subscribe("/"+rover_name+"/targetDropOffImage", 10, &RoverGUIPlugin::targetDropOffEventHandler, plugin);
+
+    // The rover list takes ownership of the item
+    list_item = new QListWidgetItem();
+    list_item->setForeground(Qt::red);
+    rover_list->addItem(list_item);
+    updateListItem();
+}
+
+void RoverConnection::disconnect()
+{
+    if (!list_item) return; // Already disconnected
+
+    status_subscriber.shutdown();
+    obstacle_subscriber.shutdown();
+    encoder_subscriber.shutdown();
+    ekf_subscriber.shutdown();
+    gps_subscriber.shutdown();
+    target_pick_up_subscriber.shutdown();
+    target_drop_off_subscriber.shutdown();
+
+    control_mode_publisher.shutdown();
+    target_pick_up_publisher.shutdown();
+    target_drop_off_publisher.shutdown();
+
+    delete rover_list->takeItem(rover_list->row(list_item));
+    list_item = NULL;
+}
+
+void RoverConnection::publishControlMode(int mode)
+{
+    std_msgs::UInt8 control_mode_msg;
+    control_mode_msg.data = mode;
+    if (control_mode_publisher) control_mode_publisher.publish(control_mode_msg);
+}
+
+void RoverConnection::publishTargetPickUp(int target_id)
+{
+    std_msgs::Int16 target_id_msg;
+    target_id_msg.data = target_id;
+    if (target_pick_up_publisher) target_pick_up_publisher.publish(target_id_msg);
+}
+
+void RoverConnection::publishTargetDropOff(int target_id)
+{
+    std_msgs::Int16 target_id_msg;
+    target_id_msg.data = target_id;
+    if (target_drop_off_publisher) target_drop_off_publisher.publish(target_id_msg);
+}
+
+void RoverConnection::updateListItem()
+{
+    if (!list_item) return;
+
+    QString rover_status;
+    {
+        QMutexLocker locker(&status_mutex);
+        rover_status = QString::fromStdString(status);
+    }
+
+    QString rover_name_and_status = QString::fromStdString(rover_name) // Add the rover name
+                                    + " (" // Delimiters needed for parsing the rover name and status when read
+                                    + rover_status // Add the rover status
+                                    + ")";
+
+    // Avoid a repaint of the list when nothing changed
+    if (list_item->text() != rover_name_and_status) list_item->setText(rover_name_and_status);
+}
+
+// Receives and stores the status update messages from the rover
+void RoverConnection::statusEventHandler(const std_msgs::String::ConstPtr& msg)
+{
+    QMutexLocker locker(&status_mutex);
+    status = msg->data;
+}
+
+}
@@ -0,0 +1,77 @@
+/*!
+ * \brief   Everything the GUI holds for one connected rover: the publishers and subscribers for the
+ *          rover's topics, its latest status, and its row in the rover list.
+ *          A RoverConnection is created once when the rover joins and destroyed once when it leaves, so
+ *          adding or removing a rover never disturbs the connections to the other rovers.
+ *          disconnect() shuts down its publishers and subscribers and removes its list row. It must be called
+ *          from the GUI thread; the connection itself may be destroyed later by a ROS callback that still
+ *          holds a reference to it.
+ *          The status is written by the ROS callback thread and read by the GUI thread, so it is guarded
+ *          by a mutex. The publish functions are safe to call from either thread and do nothing once
+ *          the connection is disconnected.
+ * \class   RoverConnection
+ */
+
+#ifndef RoverConnection_H
+#define RoverConnection_H
+
+#include <ros/ros.h>
+#include <std_msgs/String.h>
+#include <QListWidget>
+#include <QListWidgetItem>
+#include <QMutex>
+#include <string>
+
+using namespace std;
+
+namespace rqt_rover_gui
+{
+
+class RoverGUIPlugin;
+
+class RoverConnection
+{
+public:
+    RoverConnection(const string& rover_name, ros::NodeHandle& nh, RoverGUIPlugin* plugin, QListWidget* rover_list);
+
+    // Call from the GUI thread
+    void disconnect();
+
+    const string& name() const { return rover_name; }
+    QListWidgetItem* listItem() const { return list_item; }
+
+    // 1 for manual control, 2 for autonomous control
+    void publishControlMode(int mode);
+    void publishTargetPickUp(int target_id);
+    void publishTargetDropOff(int target_id);
+
+    // Refresh the text of the rover list row with the latest status. Call from the GUI thread.
+    void updateListItem();
+
+private:
+    void statusEventHandler(const std_msgs::String::ConstPtr& msg);
+
+    string rover_name;
+
+    QMutex status_mutex;
+    string status;
+
+    QListWidget* rover_list;
+    QListWidgetItem* list_item;
+
+    ros::Publisher control_mode_publisher;
+    ros::Publisher target_pick_up_publisher;
+    ros::Publisher target_drop_off_publisher;
+
+    ros::Subscriber status_subscriber;
+    ros::Subscriber obstacle_subscriber;
+    ros::Subscriber encoder_subscriber;
+    ros::Subscriber ekf_subscriber;
+    ros::Subscriber gps_subscriber;
+    ros::Subscriber target_pick_up_subscriber;
+    ros::Subscriber target_drop_off_subscriber;
+};
+
+}
+
+#endif // RoverConnection_H
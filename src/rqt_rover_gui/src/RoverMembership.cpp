@@ -0,0 +1,70 @@
+#include "RoverMembership.h"
+#include <QMutexLocker>
+#include <algorithm>
+#include <iterator>
+
+using namespace std;
+
+RoverMembership::RoverMembership(float missed_heartbeats, float minimum_timeout)
+{
+    this->missed_heartbeats = missed_heartbeats;
+    this->minimum_timeout = minimum_timeout;
+}
+
+bool RoverMembership::heartbeat(const string& rover_name, float period, bool leaving, double now)
+{
+    QMutexLocker locker(&mutex);
+
+    if (leaving)
+    {
+        return members.erase(rover_name) > 0;
+    }
+
+    bool joined = (members.count(rover_name) == 0);
+
+    Member& member = members[rover_name];
+    member.last_seen = now;
+    member.timeout = max(minimum_timeout, missed_heartbeats*period);
+
+    return joined;
+}
+
+bool RoverMembership::isMember(const string& rover_name)
+{
+    QMutexLocker locker(&mutex);
+    return members.count(rover_name) > 0;
+}
+
+void RoverMembership::remove(const string& rover_name)
+{
+    QMutexLocker locker(&mutex);
+    members.erase(rover_name);
+    reported.erase(rover_name);
+}
+
+void RoverMembership::collectChanges(double now, set<string>& joined, set<string>& left)
+{
+    set<string> current;
+
+    {
+        QMutexLocker locker(&mutex);
+
+        for (map<string, Member>::iterator it = members.begin(); it != members.end(); )
+        {
+            if (now - it->second.last_seen > it->second.timeout)
+            {
+                members.erase(it++);
+            }
+            else
+            {
+                current.insert(it->first);
+                ++it;
+            }
+        }
+    }
+
+    set_difference(current.begin(), current.end(), reported.begin(), reported.end(), inserter(joined, joined.end()));
+    set_difference(reported.begin(), reported.end(), current.begin(), current.end(), inserter(left, left.end()));
+
+    reported = current;
+}
@@ -0,0 +1,56 @@
+/*!
+ * \brief   Table of the rovers that are currently connected, built from the heartbeats rovers publish on
+ *          the /rovers/registry topic. This replaces polling the ROS master for every topic name and scanning
+ *          them for "/status": the master is not involved and the cost no longer grows with the number of topics.
+ *          A rover joins when its first heartbeat arrives and leaves when it says it is leaving or when no
+ *          heartbeat arrives for a few heartbeat periods.
+ *          heartbeat() is called from the ROS callback thread and collectChanges() from the GUI thread.
+ *          The GUI only has to create or tear down the rovers that collectChanges() reports.
+ * \class   RoverMembership
+ */
+
+#ifndef RoverMembership_H
+#define RoverMembership_H
+
+#include <QMutex>
+#include <map>
+#include <set>
+#include <string>
+
+using namespace std;
+
+class RoverMembership
+{
+public:
+    // Rovers are dropped after missing this many heartbeats, but never sooner than minimum_timeout seconds
+    RoverMembership(float missed_heartbeats = 3, float minimum_timeout = 3);
+
+    // Record a heartbeat. now is wall clock time in seconds.
+    // Returns true if the rover joined or left because of this heartbeat.
+    bool heartbeat(const string& rover_name, float period, bool leaving, double now);
+
+    // True if the rover has sent a heartbeat and has not left or timed out since
+    bool isMember(const string& rover_name);
+
+    // Forget a rover the GUI disconnected itself. It joins again if it sends another heartbeat.
+    void remove(const string& rover_name);
+
+    // Drop rovers whose heartbeats have timed out and report the rovers that joined or left since the last call
+    void collectChanges(double now, set<string>& joined, set<string>& left);
+
+private:
+    struct Member
+    {
+        double last_seen;
+        double timeout;
+    };
+
+    float missed_heartbeats;
+    float minimum_timeout;
+
+    QMutex mutex;
+    map<string, Member> members; // Current members, updated by heartbeat()
+    set<string> reported; // Members as of the last collectChanges() call
+};
+
+#endif // RoverMembership_H
@@ -0,0 +1,198 @@
+#include "RoverProcessSupervisor.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cerrno>
+#include <sstream>
+
+RoverProcessSupervisor::RoverProcessSupervisor(double grace_period)
+{
+    this->grace_period = grace_period;
+    shutting_down = false;
+    monitor = thread(&RoverProcessSupervisor::monitorLoop, this);
+}
+
+RoverProcessSupervisor::~RoverProcessSupervisor()
+{
+    stopAll();
+
+    double deadline = wallSeconds() + grace_period + 1;
+    while (runningCount() > 0 && wallSeconds() < deadline) usleep(50000);
+
+    {
+        lock_guard<mutex> lock(process_mutex);
+        shutting_down = true;
+    }
+    monitor.join();
+}
+
+bool RoverProcessSupervisor::start(const string& rover_name, const string& command, const string& log_path)
+{
+    lock_guard<mutex> lock(process_mutex);
+
+    if (processes.count(rover_name) > 0) return false;
+
+    // Only async signal safe calls are made in the child, since the GUI is multithreaded
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        setpgid(0, 0);
+
+        int log = open(log_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (log >= 0)
+        {
+            dup2(log, STDOUT_FILENO);
+            dup2(log, STDERR_FILENO);
+            close(log);
+        }
+
+        execl("/bin/sh", "sh", "-c", command.c_str(), (char*)NULL);
+        _exit(127);
+    }
+
+    if (pid < 0) return false;
+
+    // Also set from the parent so the group exists before a stop() can be sent to it
+    setpgid(pid, pid);
+
+    Process& process = processes[rover_name];
+    process.group = pid;
+    process.leader_reaped = false;
+    process.status = 0;
+    process.stopping = false;
+    process.stop_time = 0;
+    process.killed = false;
+
+    return true;
+}
+
+void RoverProcessSupervisor::stop(const string& rover_name)
+{
+    lock_guard<mutex> lock(process_mutex);
+
+    map<string, Process>::iterator it = processes.find(rover_name);
+    if (it == processes.end() || it->second.stopping) return;
+
+    // roslaunch and the nodes all get SIGINT at once, so they shut down in parallel. The nodes are not in
+    // roslaunch's group and have to be signalled one by one.
+    kill(-it->second.group, SIGINT);
+    ProcessTree::signal(it->second.nodes, SIGINT);
+    it->second.stopping = true;
+    it->second.stop_time = wallSeconds();
+}
+
+void RoverProcessSupervisor::stopAll()
+{
+    vector<string> names;
+    {
+        lock_guard<mutex> lock(process_mutex);
+        for (map<string, Process>::iterator it = processes.begin(); it != processes.end(); ++it) names.push_back(it->first);
+    }
+
+    for (size_t i = 0; i < names.size(); i++) stop(names[i]);
+}
+
+bool RoverProcessSupervisor::isRunning(const string& rover_name)
+{
+    lock_guard<mutex> lock(process_mutex);
+    return processes.count(rover_name) > 0;
+}
+
+size_t RoverProcessSupervisor::runningCount()
+{
+    lock_guard<mutex> lock(process_mutex);
+    return processes.size();
+}
+
+vector<RoverProcessSupervisor::ExitReport> RoverProcessSupervisor::collectExits()
+{
+    lock_guard<mutex> lock(process_mutex);
+
+    vector<ExitReport> collected;
+    collected.swap(exits);
+    return collected;
+}
+
+string RoverProcessSupervisor::describe(const ExitReport& report)
+{
+    ostringstream description;
+
+    if (WIFEXITED(report.status)) description << "exited with status " << WEXITSTATUS(report.status);
+    else if (WIFSIGNALED(report.status)) description << "terminated by signal " << WTERMSIG(report.status);
+    else description << "ended with wait status " << report.status;
+
+    if (report.forced) description << " (killed after not stopping)";
+
+    return description.str();
+}
+
+// Reaps each roslaunch by pid. waitpid(-1) is never used because it would also reap the QProcess children.
+void RoverProcessSupervisor::monitorLoop()
+{
+    while (true)
+    {
+        // Read before taking the lock, /proc can take a few milliseconds
+        ProcessTree tree;
+
+        {
+            lock_guard<mutex> lock(process_mutex);
+            if (shutting_down) return;
+
+            double now = wallSeconds();
+            for (map<string, Process>::iterator it = processes.begin(); it != processes.end(); )
+            {
+                Process& process = it->second;
+
+                if (!process.leader_reaped)
+                {
+                    int status;
+                    pid_t result = waitpid(process.group, &status, WNOHANG);
+                    if (result == process.group)
+                    {
+                        process.leader_reaped = true;
+                        process.status = status;
+                    }
+                    else if (result < 0 && errno == ECHILD)
+                    {
+                        process.leader_reaped = true;
+                    }
+                }
+
+                // New nodes can only be found while roslaunch is alive to be their parent
+                bool group_alive = kill(-process.group, 0) == 0 || errno == EPERM;
+                if (group_alive) tree.collect(process.group, process.nodes);
+                ProcessTree::prune(process.nodes);
+
+                if (process.stopping && !process.killed && now - process.stop_time > grace_period)
+                {
+                    kill(-process.group, SIGKILL);
+                    ProcessTree::signal(process.nodes, SIGKILL);
+                    process.killed = true;
+                }
+
+                // Nodes that outlive roslaunch keep the rover running. It only counts as stopped once they are gone.
+                if (process.leader_reaped && !group_alive && process.nodes.empty())
+                {
+                    ExitReport report = { it->first, process.status, process.killed };
+                    exits.push_back(report);
+                    processes.erase(it++);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        usleep(100000);
+    }
+}
+
+double RoverProcessSupervisor::wallSeconds()
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec + now.tv_usec * 1e-6;
+}
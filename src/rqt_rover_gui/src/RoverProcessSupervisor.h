@@ -0,0 +1,88 @@
+/*!
+ * \brief   Starts and stops the roslaunch process of each simulated rover. Each roslaunch is started as the leader
+ *          of its own process group, but roslaunch runs every node in a session of its own, so a signal to that
+ *          group only reaches sh and roslaunch. The monitor thread therefore keeps a ProcessTree list of every
+ *          process the launch started, found through the parent links while roslaunch is alive.
+ *          stop() only sends SIGINT, to roslaunch and to every node at once so they shut down in parallel, and
+ *          returns. roslaunch escalates to SIGTERM and SIGKILL on its own after about 17 s, so the grace period
+ *          is longer than that. Whatever is still alive after it, roslaunch or a node it left behind, is killed.
+ *          A rover counts as stopped once roslaunch and all of its nodes have exited. The monitor thread also
+ *          reaps roslaunch and records how it exited so the GUI can report it. All methods are thread safe.
+ * \class   RoverProcessSupervisor
+ */
+
+#ifndef RoverProcessSupervisor_H
+#define RoverProcessSupervisor_H
+
+#include <sys/types.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ProcessTree.h"
+
+using namespace std;
+
+class RoverProcessSupervisor
+{
+public:
+    struct ExitReport
+    {
+        string rover_name;
+        int status;       // From waitpid()
+        bool forced;      // Something had to be killed after the grace period
+    };
+
+    // Processes still running grace_period seconds after stop() are killed. Leave roslaunch time for its own
+    // SIGINT, SIGTERM, SIGKILL sequence, which takes about 17 s for a node that does not stop.
+    RoverProcessSupervisor(double grace_period = 20);
+
+    // Stops every rover and waits for them
+    ~RoverProcessSupervisor();
+
+    // Runs command with sh in a new process group, with its output appended to log_path.
+    // Returns false if the rover is already running or the process could not be created.
+    bool start(const string& rover_name, const string& command, const string& log_path);
+
+    // Sends SIGINT to roslaunch and every node it started and returns without waiting
+    void stop(const string& rover_name);
+    void stopAll();
+
+    // True until roslaunch and every node it started have exited
+    bool isRunning(const string& rover_name);
+    size_t runningCount();
+
+    // Returns and forgets the exits recorded since the last call
+    vector<ExitReport> collectExits();
+
+    // Describes an exit as "exited with status 0", "terminated by signal 2" etc.
+    static string describe(const ExitReport& report);
+
+private:
+    struct Process
+    {
+        pid_t group;          // The pid of the shell that runs the command, which is also the group id
+        bool leader_reaped;
+        int status;
+        bool stopping;
+        double stop_time;     // Wall clock seconds when stop() was called
+        bool killed;
+        vector<ProcessTree::TrackedProcess> nodes; // Everything the launch started, including nodes in their own sessions
+    };
+
+    void monitorLoop();
+    static double wallSeconds();
+
+    double grace_period;
+
+    mutex process_mutex;
+    map<string, Process> processes;
+    vector<ExitReport> exits;
+    bool shutting_down;
+
+    thread monitor;
+};
+
+#endif // RoverProcessSupervisor_H
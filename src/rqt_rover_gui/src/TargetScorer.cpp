@@ -0,0 +1,130 @@
+#include "TargetScorer.h"
+#include <cv_bridge/cv_bridge.h>
+#include <sensor_msgs/image_encodings.h>
+#include <opencv/cv.h>
+#include <ros/ros.h>
+
+#include "tag36h11.h"
+#include "common/zarray.h"
+
+TargetScorer::TargetScorer()
+{
+    //Initialize AprilTag detection apparatus
+    tag_family = tag36h11_create();
+    tag_detector = apriltag_detector_create();
+    apriltag_detector_add_family(tag_detector, tag_family);
+
+    u8_image = image_u8_create(320, 240);
+}
+
+TargetScorer::~TargetScorer()
+{
+    image_u8_destroy(u8_image);
+    apriltag_detector_destroy(tag_detector);
+    tag36h11_destroy(tag_family);
+}
+
+int TargetScorer::pickUp(const string& rover_name, const sensor_msgs::ImageConstPtr& image)
+{
+    lock_guard<mutex> lock(scorer_mutex);
+
+    int target_id = detect(image);
+    if (target_id < 0 || target_id == COLLECTION_ZONE_ID) return -1;
+
+    //Check all robots to ensure that no one is already holding the target
+    for (map<string, int>::iterator it = targets_picked_up.begin(); it != targets_picked_up.end(); ++it)
+    {
+        if (it->second == target_id) return -1;
+    }
+
+    //Record target ID according to the rover that reported it
+    targets_picked_up[rover_name] = target_id;
+    return target_id;
+}
+
+TargetScorer::DropOffResult TargetScorer::dropOff(const string& rover_name, const sensor_msgs::ImageConstPtr& image, int& target_id)
+{
+    lock_guard<mutex> lock(scorer_mutex);
+
+    if (detect(image) != COLLECTION_ZONE_ID) return NOT_AT_COLLECTION_ZONE;
+
+    // A rover can report the collection zone without ever having picked up a target
+    map<string, int>::iterator carried = targets_picked_up.find(rover_name);
+    if (carried == targets_picked_up.end()) return NOT_CARRYING;
+
+    target_id = carried->second;
+    targets_dropped_off[target_id] = true;
+    targets_picked_up.erase(carried);
+    return DROPPED_OFF;
+}
+
+size_t TargetScorer::carriedCount()
+{
+    lock_guard<mutex> lock(scorer_mutex);
+    return targets_picked_up.size();
+}
+
+size_t TargetScorer::collectedCount()
+{
+    lock_guard<mutex> lock(scorer_mutex);
+    return targets_dropped_off.size();
+}
+
+void TargetScorer::reset()
+{
+    lock_guard<mutex> lock(scorer_mutex);
+    targets_picked_up.clear();
+    targets_dropped_off.clear();
+}
+
+int TargetScorer::detect(const sensor_msgs::ImageConstPtr& image)
+{
+    cv_bridge::CvImagePtr cv_image;
+
+    //Let cv_bridge convert straight to greyscale, whatever encoding the camera publishes
+    try
+    {
+        cv_image = cv_bridge::toCvCopy(image, sensor_msgs::image_encodings::MONO8);
+    }
+    catch (cv_bridge::Exception& e)
+    {
+        ROS_ERROR("Could not convert from '%s' to 'mono8'.", image->encoding.c_str());
+        return -1;
+    }
+
+    cv::Mat mat_image = cv_image->image;
+
+    //The tag detector buffer is 320x240. Scale any other frame size to fit, e.g. the 640x320 simulated camera.
+    if (mat_image.cols != 320 || mat_image.rows != 240)
+    {
+        cv::resize(mat_image, mat_image, cv::Size(320, 240), cv::INTER_LINEAR);
+    }
+
+    //Copy all image data into the container the AprilTag library expects
+    for (int y = 0; y < u8_image->height; y++)
+    {
+        for (int x = 0; x < u8_image->width; x++)
+        {
+            u8_image->buf[y * u8_image->stride + x] = mat_image.data[y * mat_image.step + x];
+        }
+    }
+
+    zarray_t* detections = apriltag_detector_detect(tag_detector, u8_image);
+
+    int found = -1;
+    for (int i = 0; i < zarray_size(detections); i++)
+    {
+        apriltag_detection_t* detection;
+        zarray_get(detections, i, &detection);
+
+        //Return first tag that has not been collected
+        if (targets_dropped_off.count(detection->id) == 0)
+        {
+            found = detection->id;
+            break;
+        }
+    }
+    apriltag_detections_destroy(detections);
+
+    return found;
+}
@@ -0,0 +1,69 @@
+/*!
+ * \brief   Scores the foraging task. Rovers publish a camera image when they think they have picked up a
+ *          target and again when they think they are dropping it off at the collection zone. The scorer finds the
+ *          AprilTag in each image, decides whether the pick up or drop off counts, and keeps track of which rover
+ *          is carrying which target and which targets have been collected.
+ *
+ *          Used by the GUI and by the headless trial monitor so both score trials the same way.
+ *          All methods are thread safe.
+ * \class   TargetScorer
+ */
+
+#ifndef TargetScorer_H
+#define TargetScorer_H
+
+#include <sensor_msgs/Image.h>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "apriltag.h"
+#include "common/image_u8.h"
+
+using namespace std;
+
+class TargetScorer
+{
+public:
+    // AprilTag assigned to the collection zone
+    static const int COLLECTION_ZONE_ID = 256;
+
+    enum DropOffResult
+    {
+        NOT_AT_COLLECTION_ZONE, // The image does not show the collection zone. Nothing is published.
+        NOT_CARRYING,           // The rover is at the collection zone without a target
+        DROPPED_OFF
+    };
+
+    TargetScorer();
+    ~TargetScorer();
+
+    // Returns the ID of the target the rover picked up, or -1 if the image shows no target, the collection zone,
+    // or a target another rover is already carrying
+    int pickUp(const string& rover_name, const sensor_msgs::ImageConstPtr& image);
+
+    // On DROPPED_OFF target_id is set to the target that was collected
+    DropOffResult dropOff(const string& rover_name, const sensor_msgs::ImageConstPtr& image, int& target_id);
+
+    size_t carriedCount();   // Targets currently held by rovers
+    size_t collectedCount(); // Targets dropped off at the collection zone
+
+    void reset();
+
+private:
+    // Returns the first tag in the image that has not been collected, or -1. Called with scorer_mutex held.
+    int detect(const sensor_msgs::ImageConstPtr& image);
+
+    mutex scorer_mutex;
+
+    map<string, int> targets_picked_up; // Rover name to the target it carries
+    map<int, bool> targets_dropped_off;
+
+    apriltag_family_t* tag_family;
+    apriltag_detector_t* tag_detector;
+
+    // Allocated up front so it doesn't need to be done for every image frame
+    image_u8_t* u8_image;
+};
+
+#endif // TargetScorer_H
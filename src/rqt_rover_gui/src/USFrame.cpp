@@ -1,6 +1,7 @@
 #ifndef rqt_rover_gui_USFrame
 #define rqt_rover_gui_USFrame
 
+#include <QDateTime>
 #include <iostream>
 #include <cmath>
 
@@ -11,7 +12,6 @@ namespace rqt_rover_gui
 
 USFrame::USFrame(QWidget *parent, Qt::WFlags flags) : QFrame(parent)
 {
-    connect(this, SIGNAL(delayedUpdate()), this, SLOT(update()), Qt::QueuedConnection);
     left_range = 3.0;
     right_range = 3.0;
     center_range = 3.0;
@@ -23,6 +23,87 @@ USFrame::USFrame(QWidget *parent, Qt::WFlags flags) : QFrame(parent)
     center_min_range = 0.0;
 
     frames = 0;
+
+    // Nothing has been received yet
+    for (int sensor = 0; sensor < SENSOR_COUNT; sensor++) stale[sensor] = true;
+
+    // Drain the queued readings of all three sensors and repaint together at a fixed rate (30 Hz)
+    draw_timer = new QTimer(this);
+    connect(draw_timer, SIGNAL(timeout()), this, SLOT(drawTimerEventHandler()));
+    draw_timer->start(1000/30);
+}
+
+void USFrame::drawTimerEventHandler()
+{
+    bool received = false;
+
+    for (int sensor = 0; sensor < SENSOR_COUNT; sensor++)
+    {
+        USReading reading;
+        while (incoming_readings[sensor].pop(reading))
+        {
+            reading_history[sensor].push(reading);
+            received = true;
+        }
+    }
+
+    // Also repaint when a sensor goes quiet or comes back, so stale readings are greyed out without new data
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    bool stale_changed = false;
+    for (int sensor = 0; sensor < SENSOR_COUNT; sensor++)
+    {
+        bool is_stale = isStale(Sensor(sensor), now);
+        if (is_stale != stale[sensor]) stale_changed = true;
+        stale[sensor] = is_stale;
+    }
+
+    if (!received && !stale_changed) return;
+
+    // The rays show the newest reading of each sensor
+    if (!reading_history[LEFT].empty())
+    {
+        const USReading& latest = reading_history[LEFT][reading_history[LEFT].size()-1];
+        left_range = latest.range;
+        left_min_range = latest.min_range;
+        left_max_range = latest.max_range;
+    }
+
+    if (!reading_history[CENTER].empty())
+    {
+        const USReading& latest = reading_history[CENTER][reading_history[CENTER].size()-1];
+        center_range = latest.range;
+        center_min_range = latest.min_range;
+        center_max_range = latest.max_range;
+    }
+
+    if (!reading_history[RIGHT].empty())
+    {
+        const USReading& latest = reading_history[RIGHT][reading_history[RIGHT].size()-1];
+        right_range = latest.range;
+        right_min_range = latest.min_range;
+        right_max_range = latest.max_range;
+    }
+
+    update();
+}
+
+void USFrame::clear()
+{
+    for (int sensor = 0; sensor < SENSOR_COUNT; sensor++)
+    {
+        // The GUI thread is the consumer, so it may drain the queue
+        USReading reading;
+        while (incoming_readings[sensor].pop(reading)) {}
+
+        reading_history[sensor].clear();
+        stale[sensor] = true;
+    }
+
+    left_range = left_max_range;
+    center_range = center_max_range;
+    right_range = right_max_range;
+
+    update();
 }
 
 void USFrame::paintEvent(QPaintEvent* event)
@@ -48,9 +129,12 @@ void USFrame::paintEvent(QPaintEvent* event)
     // end frames per second
 
 
-    float frame_width = this->width();
+    // The rays use the left half of the frame and the strip chart the right half
+    float frame_width = this->width()/2;
     float frame_height = this->height();
 
+    drawStripChart(painter, QRect(frame_width+5, fm.height()+2, this->width()-frame_width-6, frame_height-2*fm.height()-4));
+
     // Use unit coordinate system and scale to the size of the frame
 
     float frame_center_x = frame_width*0.5;
@@ -73,8 +157,21 @@ void USFrame::paintEvent(QPaintEvent* event)
     QPoint right_vector = start_point + right_scale*(right_end_point-start_point);
     QPoint center_vector = start_point + center_scale*(center_end_point-start_point);
 
+    // Colorblind friendly colors, matching the strip chart
+    QColor left_color(255, 65, 30);
+    QColor center_color(17, 192, 131);
+    QColor right_color(60, 140, 255);
+
+    QColor stale_color(110, 110, 110);
+    if (stale[LEFT]) left_color = stale_color;
+    if (stale[CENTER]) center_color = stale_color;
+    if (stale[RIGHT]) right_color = stale_color;
+
+    painter.setPen(left_color);
     painter.drawLine(start_point, left_vector);
+    painter.setPen(center_color);
     painter.drawLine(start_point, center_vector);
+    painter.setPen(right_color);
     painter.drawLine(start_point, right_vector);
 
 
@@ -87,34 +184,100 @@ void USFrame::paintEvent(QPaintEvent* event)
     QString right_range_in_meters_qstr = QString::number(right_range_rounded)+"m";
     QString center_range_in_meters_qstr = QString::number(center_range_rounded)+"m";
 
-    painter.drawText(QPoint(frame_center_x-frame_width/4-fm.width(left_range_in_meters_qstr)/2,frame_height), left_range_in_meters_qstr);
+    painter.setPen(left_color);
+    painter.drawText(QPoint(frame_center_x-frame_width/3-fm.width(left_range_in_meters_qstr)/2,frame_height), left_range_in_meters_qstr);
+    painter.setPen(center_color);
     painter.drawText(QPoint(frame_center_x-fm.width(center_range_in_meters_qstr)/2,frame_height), center_range_in_meters_qstr);
-    painter.drawText(QPoint(frame_center_x+frame_width/4-fm.width(right_range_in_meters_qstr)/2,frame_height), right_range_in_meters_qstr);
+    painter.setPen(right_color);
+    painter.drawText(QPoint(frame_center_x+frame_width/3-fm.width(right_range_in_meters_qstr)/2,frame_height), right_range_in_meters_qstr);
+
+}
+
+void USFrame::drawStripChart(QPainter& painter, const QRect& area)
+{
+    // Show the last 10 seconds. The newest reading is at the right edge.
+    const qint64 window = 10000;
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    float max_range = max(left_max_range, max(center_max_range, right_max_range));
+    if (max_range <= 0) return;
+
+    QFontMetrics fm(painter.font());
+
+    // Grid line every meter
+    painter.setPen(QColor(80, 80, 80));
+    painter.drawRect(area);
+    for (int meters = 1; meters < max_range; meters++)
+    {
+        int y = area.bottom() - meters/max_range*area.height();
+        painter.drawLine(area.left(), y, area.right(), y);
+    }
+
+    painter.setPen(Qt::white);
+    painter.drawText(QPoint(area.left(), area.bottom()+fm.height()), "-" + QString::number(window/1000) + "s");
+    painter.drawText(QPoint(area.right()-fm.width("now"), area.bottom()+fm.height()), "now");
+
+    QColor colors[SENSOR_COUNT] = { QColor(255, 65, 30), QColor(17, 192, 131), QColor(60, 140, 255) };
+
+    for (int sensor = 0; sensor < SENSOR_COUNT; sensor++)
+    {
+        const USHistory& history = reading_history[sensor];
+
+        // Walk back from the newest reading until we leave the window
+        QVector<QPoint> points;
+        for (int i = history.size()-1; i >= 0; i--)
+        {
+            const USReading& reading = history[i];
+            qint64 age = now - reading.time;
+
+            float range = min(max(reading.range, 0.0f), max_range);
+            points.append(QPoint(area.right() - float(age)/window*area.width(),
+                                 area.bottom() - range/max_range*area.height()));
+
+            if (age > window) break;
+        }
+
+        painter.setPen(colors[sensor]);
+        painter.save();
+        painter.setClipRect(area);
+        painter.drawPolyline(points.data(), points.size());
+        painter.restore();
+    }
+}
+
+bool USFrame::isStale(Sensor sensor, qint64 now) const
+{
+    const USHistory& history = reading_history[sensor];
+    if (history.empty()) return true;
+
+    return now - history[history.size()-1].time > STALE_AFTER;
+}
+
+void USFrame::addReading(Sensor sensor, float r, float min, float max)
+{
+    USReading reading;
+    reading.range = r;
+    reading.min_range = min;
+    reading.max_range = max;
+    reading.time = QDateTime::currentMSecsSinceEpoch();
 
+    // If the GUI thread stalls the ring fills up and new readings are dropped rather than blocking ROS
+    incoming_readings[sensor].push(reading);
 }
 
 void USFrame::setCenterRange(float r, float min, float max)
 {
-    center_range = r;
-    center_min_range = min;
-    center_max_range = max;
-    emit delayedUpdate();
+    addReading(CENTER, r, min, max);
 }
 
 void USFrame::setLeftRange(float r, float min, float max)
 {
-    left_range = r;
-    left_min_range = min;
-    left_max_range = max;
-    emit delayedUpdate();
+    addReading(LEFT, r, min, max);
 }
 
 void USFrame::setRightRange(float r, float min, float max)
 {
-    right_range = r;
-    right_min_range = min;
-    right_max_range = max;
-    emit delayedUpdate();
+    addReading(RIGHT, r, min, max);
 }
 
 }
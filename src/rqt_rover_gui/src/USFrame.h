@@ -4,6 +4,12 @@
  *          one for each ultrasound. The length of the rays indicates the distance to any objects
  *          in front of the ultrasound. The distance in meters is displayed in text below these rays.
  *          The maximum distance reported by the ultrasounds is 3 meters.
+ *          To the right of the rays a strip chart shows the recent history of each sensor so
+ *          obstacle detections that flap on and off can be seen without recording bag files.
+ *          Readings are queued by the ROS thread in one lock-free ring buffer per sensor and the frame
+ *          drains all three and repaints at a fixed rate, so at most one repaint happens per frame.
+ *          A sensor that has not reported for STALE_AFTER milliseconds is drawn in grey, so a dead
+ *          sensor or a stalled rover does not look like a current reading.
  *
  * \author  Matthew Fricke
  * \date    November 11th 2015
@@ -15,6 +21,7 @@
 #define USFRAME_H
 
 #include <QTime> // for frame rate
+#include <QTimer>
 #include <QFrame>
 #include <QImage>
 #include <QMutex>
@@ -22,11 +29,22 @@
 #include <vector>
 #include <utility> // For STL pair
 
+#include "RingBuffer.h"
+
 using namespace std;
 
 namespace rqt_rover_gui
 {
 
+// One sonar message as queued between the ROS thread and the GUI thread
+struct USReading
+{
+    float range;
+    float min_range;
+    float max_range;
+    qint64 time; // milliseconds since the epoch when the reading was received
+};
+
 class USFrame : public QFrame
 {
     Q_OBJECT
@@ -36,18 +54,35 @@ public:
     void setLeftRange(float r, float min, float max);
     void setRightRange(float r, float min, float max);
 
-signals:
-
-    void delayedUpdate();
+    // GUI thread only. Forgets the queued readings and the history, e.g. when another rover is selected.
+    void clear();
 
 public slots:
-
+    void drawTimerEventHandler();
 
 protected:
 
     void paintEvent(QPaintEvent *event);
 
 private:
+    typedef HistoryBuffer<USReading, 256> USHistory;
+
+    enum Sensor { LEFT = 0, CENTER = 1, RIGHT = 2, SENSOR_COUNT = 3 };
+
+    // Readings older than this are shown as stale
+    static const qint64 STALE_AFTER = 1000; // milliseconds
+
+    void addReading(Sensor sensor, float r, float min, float max);
+    bool isStale(Sensor sensor, qint64 now) const;
+    void drawStripChart(QPainter& painter, const QRect& area);
+
+    // One ring per sensor so each ROS subscriber callback is the only producer for its ring
+    SPSCRingBuffer<USReading, 256> incoming_readings[SENSOR_COUNT];
+
+    // Only touched by the GUI thread
+    USHistory reading_history[SENSOR_COUNT];
+    QTimer* draw_timer;
+    bool stale[SENSOR_COUNT]; // As of the last repaint
 
     float center_range;
     float left_range;
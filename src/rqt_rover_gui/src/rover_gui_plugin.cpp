@@ -24,9 +24,11 @@
 #include <QStringList>
 #include <QLCDNumber>
 #include <QComboBox>
+#include <QDateTime>
 #include <std_msgs/Float32.h>
 #include <std_msgs/UInt8.h>
 #include <algorithm>
+#include <sstream>
 
 #include <boost/property_tree/xml_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -67,14 +69,6 @@ namespace rqt_rover_gui
     collection_disk_clearance = 0.5;
 
     barrier_clearance = 0.5; // Used to prevent targets being placed to close to walls
-
-	//Initialize AprilTag detection apparatus
-	tf = tag36h11_create();
-    td = apriltag_detector_create();
-    apriltag_detector_add_family(td, tf);
-
-    //Allocate image memory up front so it doesn't need to be done for every image frame
-    u8_image = image_u8_create(320, 240);
   }
 
   void RoverGUIPlugin::initPlugin(qt_gui_cpp::PluginContext& context)
@@ -123,16 +117,20 @@ namespace rqt_rover_gui
     connect(this, SIGNAL(joystickRightUpdate(double)), ui.joy_lcd_right, SLOT(display(double)));
     connect(this, SIGNAL(updateObstacleCallCount(QString)), ui.perc_of_time_avoiding_obstacles, SLOT(setText(QString)));
     connect(this, SIGNAL(updateLog(QString)), this, SLOT(displayLogMessage(QString)));
+    connect(this, SIGNAL(roverMembershipChanged()), this, SLOT(updateRoverMembershipEventHandler()), Qt::QueuedConnection);
 
     // Create a subscriber to listen for joystick events
     joystick_subscriber = nh.subscribe("/joy", 1000, &RoverGUIPlugin::joyEventHandler, this);
 
     displayLogMessage("Searching for rovers...");
 
-    // Add discovered rovers to the GUI list
-    rover_poll_timer = new QTimer(this);
-    connect(rover_poll_timer, SIGNAL(timeout()), this, SLOT(pollRoversTimerEventHandler()));
-    rover_poll_timer->start(5000);
+    // Rovers announce themselves on the registry topic. Joins and explicit leaves are handled as soon as
+    // the heartbeat arrives, the timer catches rovers that stopped sending heartbeats and refreshes statuses.
+    rover_registry_subscriber = nh.subscribe("/rovers/registry", 100, &RoverGUIPlugin::roverHeartbeatEventHandler, this);
+
+    rover_membership_timer = new QTimer(this);
+    connect(rover_membership_timer, SIGNAL(timeout()), this, SLOT(updateRoverMembershipEventHandler()));
+    rover_membership_timer->start(1000);
 
     // Setup the initial display parameters for the map
     ui.map_frame->setDisplayGPSData(ui.gps_checkbox->isChecked());
@@ -162,7 +160,7 @@ namespace rqt_rover_gui
   void RoverGUIPlugin::shutdownPlugin()
   {
     clearSimulationButtonEventHandler();
-    rover_poll_timer->stop();
+    rover_membership_timer->stop();
     stopROSJoyNode();
     ros::shutdown();
   }
@@ -333,35 +331,14 @@ void RoverGUIPlugin::GPSEventHandler(const ros::MessageEvent<const nav_msgs::Odo
      ui.camera_frame->setImage(qimg);
  }
 
-set<string> RoverGUIPlugin::findConnectedRovers()
+void RoverGUIPlugin::roverHeartbeatEventHandler(const shared_messages::RoverHeartbeat::ConstPtr& msg)
 {
-    set<string> rovers;
-
-    ros::master::V_TopicInfo master_topics;
-    ros::master::getTopics(master_topics);
-
-    stringstream ss;
-
-   for (ros::master::V_TopicInfo::iterator it = master_topics.begin() ; it != master_topics.end(); it++)
+    // Wall time so rovers do not time out while the simulation clock is paused
+    if (rover_membership.heartbeat(msg->rover_name, msg->period, msg->leaving, ros::WallTime::now().toSec()))
     {
-        const ros::master::TopicInfo& info = *it;
-
-        string rover_name;
-
-        std::size_t found = info.name.find("/status");
-          if (found!=std::string::npos)
-          {
-            rover_name = info.name.substr(1,found-1);
-
-            found = rover_name.find("/"); // Eliminate potential names with / in them
-            if (found==std::string::npos)
-            {
-                rovers.insert(rover_name);
-            }
-        }
+        // Called from the ROS thread. Let the GUI thread add or remove the rover.
+        emit roverMembershipChanged();
     }
-
-    return rovers;
 }
 
 void RoverGUIPlugin::targetPickUpEventHandler(const ros::MessageEvent<const sensor_msgs::Image> &event)
@@ -377,35 +354,23 @@ void RoverGUIPlugin::targetPickUpEventHandler(const ros::MessageEvent<const sens
     size_t found = topic.find("/targetPickUpImage");
     string rover_name = topic.substr(1,found-1);
 
-    int targetID = targetDetect(image);
-    
-    //Check all robots to ensure that no one is already holding the target
-    bool targetPreviouslyCollected = false;
-	for (map<string,int>::iterator it=targetsPickedUp.begin(); it!=targetsPickedUp.end(); ++it) {
-		if (it->second == targetID) {
-			targetPreviouslyCollected = true;
-			break;
-		}
-	}
-	
-    if((targetID < 0) || (targetID == collectionZoneID) || targetPreviouslyCollected) {
+    boost::shared_ptr<RoverConnection> connection = findRoverConnection(rover_name);
+    if (!connection) return; // The rover disconnected
+
+    int targetID = target_scorer.pickUp(rover_name, image);
+
+    if (targetID < 0) {
         // No valid target was found in the image, or the target was the collection zone ID, or the target was already picked up by another robot
-        
-        //Publish -1 to alert robot of failed drop off event
-        std_msgs::Int16 targetIDMsg;
-        targetIDMsg.data = -1;
-        targetPickUpPublisher[rover_name].publish(targetIDMsg);
+
+        //Publish -1 to alert robot of failed pick up event
+        connection->publishTargetPickUp(-1);
     }
     else {
-		//Record target ID according to the rover that reported it
-        targetsPickedUp[rover_name] = targetID;
         emit updateLog("Resource " + QString::number(targetID) + " picked up by " + QString::fromStdString(rover_name));
-        ui.num_targets_detected_label->setText(QString("<font color='white'>")+QString::number(targetsPickedUp.size())+QString("</font>"));
-        
+        ui.num_targets_detected_label->setText(QString("<font color='white'>")+QString::number(target_scorer.carriedCount())+QString("</font>"));
+
         //Publish target ID
-        std_msgs::Int16 targetIDMsg;
-        targetIDMsg.data = targetID;
-        targetPickUpPublisher[rover_name].publish(targetIDMsg);
+        connection->publishTargetPickUp(targetID);
     }
 }
 
@@ -422,53 +387,32 @@ void RoverGUIPlugin::targetDropOffEventHandler(const ros::MessageEvent<const sen
     size_t found = topic.find("/targetDropOffImage");
     string rover_name = topic.substr(1,found-1);
 
-    int targetID = targetDetect(image);
+    boost::shared_ptr<RoverConnection> connection = findRoverConnection(rover_name);
+    if (!connection) return; // The rover disconnected
 
-    if(targetID != collectionZoneID) {
+    int targetID = -1;
+    switch (target_scorer.dropOff(rover_name, image, targetID))
+    {
+    case TargetScorer::NOT_AT_COLLECTION_ZONE:
         // This target does not match the official collection zone ID
-    }
-    else {
-		//Use try-catch here in case a rover reports the collection zone ID without ever having picked up a target
-        try {
-			//Add target ID to list of dropped off targets
-            targetsDroppedOff[targetsPickedUp.at(rover_name)] = true;
-            emit updateLog("Resource " + QString::number(targetsPickedUp.at(rover_name)) + " dropped off by " + QString::fromStdString(rover_name));
-            ui.num_targets_collected_label->setText(QString("<font color='white'>")+QString::number(targetsDroppedOff.size())+QString("</font>"));
-            targetsPickedUp.erase(rover_name);
-            ui.num_targets_detected_label->setText(QString("<font color='white'>")+QString::number(targetsPickedUp.size())+QString("</font>"));
-            
-            //Publish target ID (should always be equal to 256)
-			std_msgs::Int16 targetIDMsg;
-			targetIDMsg.data = targetID;
-			targetDropOffPublisher[rover_name].publish(targetIDMsg);
-        }
-        catch(const std::out_of_range& oor) {
-            emit updateLog(QString::fromStdString(rover_name) + " attempted a drop off but was not carrying a target");
-            
-            //Publish -1 to alert robot of failed drop off event
-            std_msgs::Int16 targetIDMsg;
-			targetIDMsg.data = -1;
-			targetDropOffPublisher[rover_name].publish(targetIDMsg);
-        }
-    }
-}
-
-// Receives and stores the status update messages from rovers
-void RoverGUIPlugin::statusEventHandler(const ros::MessageEvent<std_msgs::String const> &event)
-{
-    const ros::M_string& header = event.getConnectionHeader();
-    ros::Time receipt_time = event.getReceiptTime();
+        break;
 
-    // Extract rover name from the message source
-    string topic = header.at("topic");
-    size_t found = topic.find("/status");
-    string rover_name = topic.substr(1,found-1);
+    case TargetScorer::NOT_CARRYING:
+        emit updateLog(QString::fromStdString(rover_name) + " attempted a drop off but was not carrying a target");
 
-    const std_msgs::StringConstPtr& msg = event.getMessage();
+        //Publish -1 to alert robot of failed drop off event
+        connection->publishTargetDropOff(-1);
+        break;
 
-    string status = msg->data;
+    case TargetScorer::DROPPED_OFF:
+        emit updateLog("Resource " + QString::number(targetID) + " dropped off by " + QString::fromStdString(rover_name));
+        ui.num_targets_collected_label->setText(QString("<font color='white'>")+QString::number(target_scorer.collectedCount())+QString("</font>"));
+        ui.num_targets_detected_label->setText(QString("<font color='white'>")+QString::number(target_scorer.carriedCount())+QString("</font>"));
 
-    rover_statuses[rover_name] = status;
+        //Publish the collection zone ID
+        connection->publishTargetDropOff(TargetScorer::COLLECTION_ZONE_ID);
+        break;
+    }
 }
 
 // Counts the number of obstacle avoidance calls
@@ -512,24 +456,23 @@ void RoverGUIPlugin::currentRoverChangedEventHandler(QListWidgetItem *current, Q
 
     displayLogMessage(QString("Selected rover: ") + QString::fromStdString(selected_rover_name));
 
-    // Attempt to read the simulation model xml file if it exists. If it does not exist assume this is a physical rover.
-    const char *name = "GAZEBO_MODEL_PATH";
-    char *model_root_cstr;
-    model_root_cstr = getenv(name);
-    QString model_root(model_root_cstr);
-
-    QString model_path = model_root+"/"+QString::fromStdString(selected_rover_name)+"/model.sdf";
-
-    readRoverModelXML(model_path);
+    // Simulated rovers are generated from the rover SDF template. Any other rover is assumed to be physical.
+    string model_sdf = sim_mgr.roverModelSDF(QString::fromStdString(selected_rover_name));
+    if (model_sdf.empty()) displayLogMessage(QString::fromStdString(selected_rover_name) + " appears to be a physical rover.");
+    else readRoverModelXML(model_sdf);
     
     //Set up subscribers
     image_transport::ImageTransport it(nh);
     camera_subscriber = it.subscribe("/"+selected_rover_name+"/camera/image", 1, &RoverGUIPlugin::cameraEventHandler, this, image_transport::TransportHints("theora"));
-    imu_subscriber = nh.subscribe("/"+selected_rover_name+"/imu", 10, &RoverGUIPlugin::IMUEventHandler, this);
+    imu_subscriber = nh.subscribe("/"+selected_rover_name+"/imu", 100, &RoverGUIPlugin::IMUEventHandler, this);
     us_center_subscriber = nh.subscribe("/"+selected_rover_name+"/sonarCenter", 10, &RoverGUIPlugin::centerUSEventHandler, this);
     us_left_subscriber = nh.subscribe("/"+selected_rover_name+"/sonarLeft", 10, &RoverGUIPlugin::leftUSEventHandler, this);
     us_right_subscriber = nh.subscribe("/"+selected_rover_name+"/sonarRight", 10, &RoverGUIPlugin::rightUSEventHandler, this);
 
+    // Start the strip charts afresh so the previous rover's samples are not plotted as this one's
+    ui.imu_frame->clear();
+    ui.us_frame->clear();
+
     displayLogMessage(QString("Displaying map for ")+QString::fromStdString(selected_rover_name));
     ui.map_frame->setRoverMapToDisplay(selected_rover_name);
 
@@ -576,77 +519,32 @@ void RoverGUIPlugin::currentRoverChangedEventHandler(QListWidgetItem *current, Q
     ui.joystick_control_radio_button->setEnabled(true);
 }
 
-void RoverGUIPlugin::pollRoversTimerEventHandler()
+void RoverGUIPlugin::updateRoverMembershipEventHandler()
 {
-    set<string>new_rover_names = findConnectedRovers();
+    set<string> joined_rover_names;
+    set<string> left_rover_names;
+    rover_membership.collectChanges(ros::WallTime::now().toSec(), joined_rover_names, left_rover_names);
 
-
-    std::set<string> orphaned_rover_names;
-
-    // Calculate which of the old rover names are not in the new list of rovers then clear their maps and control states.
-    std::set_difference(rover_names.begin(), rover_names.end(), new_rover_names.begin(), new_rover_names.end(),
-        std::inserter(orphaned_rover_names, orphaned_rover_names.end()));
-
-    for (set<string>::iterator it = orphaned_rover_names.begin(); it != orphaned_rover_names.end(); ++it)
+    // Only the rovers that left or joined are touched. Connections to the other rovers are kept.
+    for (set<string>::iterator it = left_rover_names.begin(); it != left_rover_names.end(); ++it)
     {
-        displayLogMessage(QString("Clearing interface data for disconnected rover ") + QString::fromStdString(*it));
-        ui.map_frame->clearMap(*it);
-        rover_control_state.erase(*it); // Remove the control state for orphaned rovers
-        rover_statuses.erase(*it);
+        removeRover(*it);
+    }
 
-        // If the currently selected rover disconnected, shutdown its subscribers and publishers
-        if (it->compare(selected_rover_name) == 0)
-        {
-            camera_subscriber.shutdown();
-            imu_subscriber.shutdown();
-            us_center_subscriber.shutdown();
-            us_left_subscriber.shutdown();
-            us_right_subscriber.shutdown();
-            joystick_publisher.shutdown();
-            
-            //Reset selected rover name to empty string
-            selected_rover_name = "";
-        }
+    for (set<string>::iterator it = joined_rover_names.begin(); it != joined_rover_names.end(); ++it)
+    {
+        addRover(*it);
+    }
 
-        // For the other rovers that disconnected...
-
-        // Shutdown the subscribers
-        status_subscribers[*it].shutdown();
-        encoder_subscribers[*it].shutdown();
-        gps_subscribers[*it].shutdown();
-        ekf_subscribers[*it].shutdown();
-        targetPickUpSubscribers[*it].shutdown();
-        targetDropOffSubscribers[*it].shutdown();
-
-        // Delete the subscribers
-        status_subscribers.erase(*it);
-        encoder_subscribers.erase(*it);
-        gps_subscribers.erase(*it);
-        ekf_subscribers.erase(*it);
-        targetPickUpSubscribers.erase(*it);
-        targetDropOffSubscribers.erase(*it);
-        
-        // Shudown Publishers
-        control_mode_publishers[*it].shutdown();
-        targetPickUpPublisher[*it].shutdown();
-        targetDropOffPublisher[*it].shutdown();
-
-        // Delete Publishers
-        control_mode_publishers.erase(*it);
-        targetPickUpPublisher.erase(*it);
-        targetDropOffPublisher.erase(*it);
+    if (!joined_rover_names.empty() || !left_rover_names.empty())
+    {
+        displayLogMessage("List of connected rovers has changed");
+        ui.rover_list->sortItems();
     }
 
     // Wait for a rover to connect
-    if (new_rover_names.empty())
+    if (rover_connections.empty())
     {
-        //displayLogMessage("Waiting for rover to connect...");
-        selected_rover_name = "";
-        rover_control_state.clear();
-        rover_names.clear();        
-        ui.rover_list->clearSelection();
-        ui.rover_list->clear();
-
         // Disable control mode group since no rovers are connected
         ui.autonomous_control_radio_button->setEnabled(false);
         ui.joystick_control_radio_button->setEnabled(false);
@@ -657,98 +555,74 @@ void RoverGUIPlugin::pollRoversTimerEventHandler()
         return;
     }
 
-    if (new_rover_names == rover_names)
+    if (!joined_rover_names.empty())
     {
+        //Enable all autonomous button
+        ui.all_autonomous_button->setEnabled(true);
+        ui.all_autonomous_button->setStyleSheet("color: white; border:2px solid white;");
+    }
 
-        // Just update the statuses in ui rover list
-        for(int row = 0; row < ui.rover_list->count(); row++)
-        {
-            QListWidgetItem *item = ui.rover_list->item(row);
-
-            // Extract rover name
-            string rover_name_and_status = item->text().toStdString();
-
-            // Rover names start at the begining of the rover name and status string and end at the first space
-            size_t rover_name_length = rover_name_and_status.find_first_of(" ");
-            string ui_rover_name = rover_name_and_status.substr(0, rover_name_length);
+    // Update the statuses in ui rover list
+    for (map<string, boost::shared_ptr<RoverConnection> >::iterator it = rover_connections.begin(); it != rover_connections.end(); ++it)
+    {
+        it->second->updateListItem();
+    }
+}
 
-            // Get current status
+void RoverGUIPlugin::addRover(const string& rover_name)
+{
+    if (rover_connections.count(rover_name)) return; // Already connected
 
-            QString updated_rover_status = "";
-            // Build new ui rover list string
-            try
-            {
-                updated_rover_status = QString::fromStdString(rover_statuses.at(ui_rover_name));
-            }
-            catch (std::out_of_range& e)
-            {
-                emit displayLogMessage("Error: No status entry for rover " + QString::fromStdString(ui_rover_name));
-            }
+    // Creating the connection advertises, subscribes, and adds the rover to the ui rover list
+    boost::shared_ptr<RoverConnection> connection(new RoverConnection(rover_name, nh, this, ui.rover_list));
 
+    QMutexLocker locker(&rover_connections_mutex);
+    rover_connections[rover_name] = connection;
+}
 
-            // Build new ui rover list string
-            QString updated_rover_name_and_status = QString::fromStdString(ui_rover_name)
-                                                    + " ("
-                                                    + updated_rover_status
-                                                    + ")";
+void RoverGUIPlugin::removeRover(const string& rover_name)
+{
+    boost::shared_ptr<RoverConnection> connection;
 
-            // Update the UI
-            item->setText(updated_rover_name_and_status);
-        }
+    {
+        QMutexLocker locker(&rover_connections_mutex);
+        map<string, boost::shared_ptr<RoverConnection> >::iterator it = rover_connections.find(rover_name);
+        if (it == rover_connections.end()) return; // Not connected
 
-        return;
+        connection = it->second;
+        rover_connections.erase(it);
     }
 
-    rover_names = new_rover_names;
-    
-    displayLogMessage("List of connected rovers has changed");
-    selected_rover_name = "";
-    ui.rover_list->clearSelection();
-    ui.rover_list->clear();
-    
-    //Enable all autonomous button
-    ui.all_autonomous_button->setEnabled(true);
-    ui.all_autonomous_button->setStyleSheet("color: white; border:2px solid white;");
+    displayLogMessage(QString("Clearing interface data for disconnected rover ") + QString::fromStdString(rover_name));
+    ui.map_frame->clearMap(rover_name);
+    rover_control_state.erase(rover_name); // Remove the control state for orphaned rovers
 
-    // This code is from above. Consider moving into a function or restructuring
-    for(set<string>::const_iterator i = rover_names.begin(); i != rover_names.end(); ++i)
+    // If the currently selected rover disconnected, shutdown its subscribers and publishers
+    if (rover_name.compare(selected_rover_name) == 0)
     {
-        //Set up publishers
-        control_mode_publishers[*i]=nh.advertise<std_msgs::UInt8>("/"+*i+"/mode", 10, true); // last argument sets latch to true
-        targetPickUpPublisher[*i] = nh.advertise<std_msgs::Int16>("/"+*i+"/targetPickUpValue", 10, this);
-        targetDropOffPublisher[*i] = nh.advertise<std_msgs::Int16>("/"+*i+"/targetDropOffValue", 10, this);
-
-        //Set up subscribers
-        status_subscribers[*i] = nh.subscribe("/"+*i+"/status", 10, &RoverGUIPlugin::statusEventHandler, this);
-        obstacle_subscribers[*i] = nh.subscribe("/"+*i+"/obstacle", 10, &RoverGUIPlugin::obstacleEventHandler, this);
-        encoder_subscribers[*i] = nh.subscribe("/"+*i+"/odom/", 10, &RoverGUIPlugin::encoderEventHandler, this);
-        ekf_subscribers[*i] = nh.subscribe("/"+*i+"/odom/ekf", 10, &RoverGUIPlugin::EKFEventHandler, this);
-        gps_subscribers[*i] = nh.subscribe("/"+*i+"/odom/navsat", 10, &RoverGUIPlugin::GPSEventHandler, this);
-        targetPickUpSubscribers[*i] = nh.subscribe("/"+*i+"/targetPickUpImage", 10, &RoverGUIPlugin::targetPickUpEventHandler, this);
-        targetDropOffSubscribers[*i] = nh.subscribe("/"+*i+"/targetDropOffImage", 10, &RoverGUIPlugin::targetDropOffEventHandler, this);
-
-        QString rover_status = "";
-        // Build new ui rover list string
-        try
-        {
-            rover_status = QString::fromStdString(rover_statuses.at(*i));
-        }
-        catch (std::out_of_range& e)
-        {
-            displayLogMessage("No status entry for rover " + QString::fromStdString(*i));
-        }
-
-        QString rover_name_and_status = QString::fromStdString(*i) // Add the rover name
-                                                + " (" // Delimiters needed for parsing the rover name and status when read
-                                                +  rover_status // Add the rover status
-                                                + ")";
+        camera_subscriber.shutdown();
+        imu_subscriber.shutdown();
+        us_center_subscriber.shutdown();
+        us_left_subscriber.shutdown();
+        us_right_subscriber.shutdown();
+        joystick_publisher.shutdown();
+
+        //Reset selected rover name to empty string
+        selected_rover_name = "";
+        ui.rover_list->clearSelection();
+    }
 
-        QListWidgetItem* new_item = new QListWidgetItem(rover_name_and_status);
-        new_item->setForeground(Qt::red);
-        ui.rover_list->addItem(new_item);
-        
+    // Shut down the publishers and subscribers and remove the list row here on the GUI thread.
+    // A ROS callback that is still running may hold the last reference to the connection.
+    connection->disconnect();
+}
 
-    }
+boost::shared_ptr<RoverConnection> RoverGUIPlugin::findRoverConnection(const string& rover_name)
+{
+    QMutexLocker locker(&rover_connections_mutex);
+    map<string, boost::shared_ptr<RoverConnection> >::iterator it = rover_connections.find(rover_name);
+    if (it == rover_connections.end()) return boost::shared_ptr<RoverConnection>();
+    return it->second;
 }
 
 void RoverGUIPlugin::centerUSEventHandler(const sensor_msgs::Range::ConstPtr& msg)
@@ -788,19 +662,13 @@ void RoverGUIPlugin::leftUSEventHandler(const sensor_msgs::Range::ConstPtr& msg)
 
 void RoverGUIPlugin::IMUEventHandler(const sensor_msgs::Imu::ConstPtr& msg)
 {
-    ui.imu_frame->setLinearAcceleration( msg->linear_acceleration.x,
-                                         msg->linear_acceleration.y,
-                                         msg->linear_acceleration.z );
-
-    ui.imu_frame->setAngularVelocity(    msg->angular_velocity.x,
-                                         msg->angular_velocity.y,
-                                         msg->angular_velocity.z    );
-
-    ui.imu_frame->setOrientation(        msg->orientation.w,
-                                         msg->orientation.x,
-                                         msg->orientation.y,
-                                         msg->orientation.z        );
+    // Queue the sample. The IMU frame drains the queue and redraws on its own timer.
+    IMUSample sample;
+    sample.linear_acceleration = Vec3(msg->linear_acceleration.x, msg->linear_acceleration.y, msg->linear_acceleration.z);
+    sample.angular_velocity = Vec3(msg->angular_velocity.x, msg->angular_velocity.y, msg->angular_velocity.z);
+    sample.orientation = Quat(msg->orientation.w, msg->orientation.x, msg->orientation.y, msg->orientation.z);
 
+    ui.imu_frame->addSample(sample);
 }
 
 void RoverGUIPlugin::GPSCheckboxToggledEventHandler(bool checked)
@@ -849,10 +717,9 @@ void RoverGUIPlugin::autonomousRadioButtonEventHandler(bool marked)
 
     rover_control_state[selected_rover_name] = 2;
 
-    std_msgs::UInt8 control_mode_msg;
-    control_mode_msg.data = 2; // 2 indicates autonomous control
+    boost::shared_ptr<RoverConnection> connection = findRoverConnection(selected_rover_name);
+    if (connection) connection->publishControlMode(2); // 2 indicates autonomous control
 
-    control_mode_publishers[selected_rover_name].publish(control_mode_msg);
     displayLogMessage(QString::fromStdString(selected_rover_name)+" changed to autonomous control");
 
     QString return_msg = stopROSJoyNode();
@@ -874,10 +741,9 @@ void RoverGUIPlugin::joystickRadioButtonEventHandler(bool marked)
     displayLogMessage("Setting up joystick publisher " + QString::fromStdString("/"+selected_rover_name+"/joystick"));
     joystick_publisher = nh.advertise<geometry_msgs::Twist>("/"+selected_rover_name+"/joystick", 10, this);
 
-    std_msgs::UInt8 control_mode_msg;
-    control_mode_msg.data = 1; // 1 indicates manual control
+    boost::shared_ptr<RoverConnection> connection = findRoverConnection(selected_rover_name);
+    if (connection) connection->publishControlMode(1); // 1 indicates manual control
 
-    control_mode_publishers[selected_rover_name].publish(control_mode_msg);
     displayLogMessage(QString::fromStdString(selected_rover_name)+" changed to joystick control");\
 
     QString return_msg = startROSJoyNode();
@@ -900,10 +766,10 @@ void RoverGUIPlugin::allAutonomousButtonEventHandler()
     int selected_index = -1; // zero array indexing, ensure last selected index is in range
 
     // manually trigger the autonomous radio button event for all rovers
-    for (set<string>::iterator it = rover_names.begin(); it != rover_names.end(); it++)
+    for (map<string, boost::shared_ptr<RoverConnection> >::iterator it = rover_connections.begin(); it != rover_connections.end(); it++)
     {
         selected_index++;
-        selected_rover_name = *it;
+        selected_rover_name = it->first;
         autonomousRadioButtonEventHandler(true);
     }
 
@@ -940,10 +806,10 @@ void RoverGUIPlugin::allStopButtonEventHandler()
     int selected_index = -1; // zero array indexing, ensure last selected index is in range
 
     // manually trigger the manual radio button event for all rovers
-    for (set<string>::iterator it = rover_names.begin(); it != rover_names.end(); it++)
+    for (map<string, boost::shared_ptr<RoverConnection> >::iterator it = rover_connections.begin(); it != rover_connections.end(); it++)
     {
         selected_index++;
-        selected_rover_name = *it;
+        selected_rover_name = it->first;
         joystickRadioButtonEventHandler(true);
     }
 
@@ -990,21 +856,19 @@ void RoverGUIPlugin::buildSimulationButtonEventHandler()
     // Initialize the target counts
     ui.num_targets_collected_label->setText(QString("<font color='white'>0</font>"));
     ui.num_targets_detected_label->setText(QString("<font color='white'>0</font>"));
-    targetsPickedUp.clear();
-    targetsDroppedOff.clear();
-
-    QProcess* sim_server_process = sim_mgr.startGazeboServer();
-    connect(sim_server_process, SIGNAL(finished(int)), this, SLOT(gazeboServerFinishedEventHandler()));
+    target_scorer.reset();
 
+    // Lay out the whole trial in memory first. Nothing is sent to gazebo until the world file is written.
+    sim_mgr.beginWorld();
 
     if (ui.final_radio_button->isChecked())
     {
-         arena_dim = 23.1;
+         arena_dim = sim_layout::FINAL_ARENA_DIM;
          addFinalsWalls();
     }
     else
     {
-        arena_dim = 15;
+        arena_dim = sim_layout::PRELIM_ARENA_DIM;
         addPrelimsWalls();
     }
 
@@ -1038,107 +902,76 @@ void RoverGUIPlugin::buildSimulationButtonEventHandler()
     float collection_disk_radius = 0.5; // meters
     sim_mgr.addModel("collection_disk", "collection_disk", 0, 0, 0, collection_disk_radius);
 
-    int n_rovers_created = 0;
-    int n_rovers = 3;
-    if (ui.final_radio_button->isChecked()) n_rovers = 6;
-
-    QProgressDialog progress_dialog;
-    progress_dialog.setWindowTitle("Creating rovers");
-    progress_dialog.setCancelButton(NULL); // no cancel button
-    progress_dialog.setWindowModality(Qt::ApplicationModal);
-    progress_dialog.setWindowFlags(progress_dialog.windowFlags() | Qt::WindowStaysOnTopHint);
-    progress_dialog.resize(500, 50);
-    progress_dialog.show();
-
-    displayLogMessage("Adding rover achilles...");
-    return_msg = sim_mgr.addRover("achilles", 0, 1, 0);
-    displayLogMessage(return_msg);
-
-    displayLogMessage("Starting rover node for achilles...");
-    return_msg = sim_mgr.startRoverNode("achilles");
-    displayLogMessage(return_msg);
-
-    progress_dialog.setValue((++n_rovers_created)*100.0f/n_rovers);
-    qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
+    // The preliminary round uses the first three rovers. Larger swarms are run with sim_runner --rovers.
+    int n_rovers = sim_layout::PRELIM_ROVERS;
+    if (ui.final_radio_button->isChecked()) n_rovers = sim_layout::FINAL_ROVERS;
 
-    displayLogMessage("Adding rover aeneas...");
-    return_msg = sim_mgr.addRover("aeneas", -1, 0, 0);
-    displayLogMessage(return_msg);
-
-    displayLogMessage("Starting rover node for aeneas...");
-    return_msg = sim_mgr.startRoverNode("aeneas");
-    displayLogMessage(return_msg);
-
-    progress_dialog.setValue((++n_rovers_created)*100.0f/n_rovers);
-    qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-
-    displayLogMessage("Adding rover ajax...");
-    return_msg = sim_mgr.addRover("ajax", 1, 0, 0);
-    displayLogMessage(return_msg);
-
-   displayLogMessage("Starting rover node for ajax...");
-   return_msg = sim_mgr.startRoverNode("ajax");
-   displayLogMessage(return_msg);
-
-   progress_dialog.setValue((++n_rovers_created)*100.0f/n_rovers);
-   qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-
-   if (ui.final_radio_button->isChecked())
-   {
-
-       displayLogMessage("Adding rover diomedes...");
-       return_msg = sim_mgr.addRover("diomedes", 1, 1, 0);
-       displayLogMessage(return_msg);
-
-       displayLogMessage("Starting rover node for diomedes...");
-       return_msg = sim_mgr.startRoverNode("diomedes");
-       displayLogMessage(return_msg);
-
-       progress_dialog.setValue((++n_rovers_created)*100.0f/n_rovers);
-       qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-
-       displayLogMessage("Adding rover hector...");
-       return_msg = sim_mgr.addRover("hector", -1, -1, 0);
-       displayLogMessage(return_msg);
-
-       displayLogMessage("Starting rover node for hector...");
-       return_msg = sim_mgr.startRoverNode("hector");
-       displayLogMessage(return_msg);
-
-        progress_dialog.setValue((++n_rovers_created)*100.0f/n_rovers);
-        qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-
-       displayLogMessage("Adding rover paris...");
-       return_msg = sim_mgr.addRover("paris", 1, -1, 0);
-       displayLogMessage(return_msg);
-
-       displayLogMessage("Starting rover node for paris...");
-       return_msg = sim_mgr.startRoverNode("paris");
-       displayLogMessage(return_msg);
-
-        progress_dialog.setValue((++n_rovers_created)*100.0f/n_rovers);
-        qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
+    QStringList rover_names;
+    for (int i = 0; i < n_rovers; i++)
+    {
+        rover_names << QString::fromStdString(sim_layout::roverName(i));
+        displayLogMessage("Adding rover " + rover_names.back() + "...");
+        return_msg = sim_mgr.addRover(i);
+        displayLogMessage(return_msg);
+    }
 
-}
    if (ui.powerlaw_distribution_radio_button->isChecked())
    {
        displayLogMessage("Adding powerlaw distribution of targets...");
-       return_msg = addPowerLawTargets();
+       return_msg = addTargets(sim_layout::POWER_LAW, n_rovers);
        displayLogMessage(return_msg);
    }
    else if (ui.uniform_distribution_radio_button->isChecked())
    {
        displayLogMessage("Adding uniform distribution of targets...");
-       return_msg = addUniformTargets();
+       return_msg = addTargets(sim_layout::UNIFORM, n_rovers);
        displayLogMessage(return_msg);
    }
    else if (ui.clustered_distribution_radio_button->isChecked())
    {
        displayLogMessage("Adding clustered distribution of targets...");
-       return_msg = addClusteredTargets();
+       return_msg = addTargets(sim_layout::CLUSTERED, n_rovers);
        displayLogMessage(return_msg);
    }
 
+   // Gazebo loads every model from the generated world file in one go
+   QString world_path = sim_mgr.endWorld();
+   if (world_path.isEmpty())
+   {
+       displayLogMessage("<font color='red'>Could not write the simulation world file.</font>");
+       ui.build_simulation_button->setEnabled(true);
+       ui.build_simulation_button->setStyleSheet("color: white; border:1px solid white;");
+       return;
+   }
+   displayLogMessage("Wrote simulation world to " + world_path);
+
+   QProcess* sim_server_process = sim_mgr.startGazeboServer(world_path);
+   connect(sim_server_process, SIGNAL(finished(int)), this, SLOT(gazeboServerFinishedEventHandler()));
+
+   if (!sim_mgr.waitForGazeboServer(60))
+   {
+       displayLogMessage("<font color='red'>Timed out waiting for the gazebo server to start.</font>");
+   }
+
+   QProgressDialog progress_dialog;
+   progress_dialog.setWindowTitle("Starting rovers");
+   progress_dialog.setCancelButton(NULL); // no cancel button
+   progress_dialog.setWindowModality(Qt::ApplicationModal);
+   progress_dialog.setWindowFlags(progress_dialog.windowFlags() | Qt::WindowStaysOnTopHint);
+   progress_dialog.resize(500, 50);
+   progress_dialog.show();
+
+   // All the launch files are started at once and the rovers come up concurrently
+   displayLogMessage("Starting rover nodes for " + rover_names.join(", ") + "...");
+   return_msg = sim_mgr.startRoverNodes(n_rovers);
+   displayLogMessage(return_msg);
+
+   QStringList failed_rovers = waitForRoverNodes(rover_names, 60, progress_dialog);
+   if (!failed_rovers.isEmpty())
+   {
+       displayLogMessage("<font color='red'>Rovers that did not start: " + failed_rovers.join(", ") + "</font>");
+   }
+
    // add walls given nw corner (x,y) and height and width (in meters)
 
    //addWalls(-arena_dim/2, -arena_dim/2, arena_dim, arena_dim);
@@ -1184,53 +1017,36 @@ void RoverGUIPlugin::clearSimulationButtonEventHandler()
     progress_dialog.show();
 
     QString return_msg;
-    float count = 0.0f;
 
-    // Make a copy of the rover names because stopRoverNode will cause the original set to change
-    set<string> rover_names_copy = rover_names;
+    // Only the rovers this GUI started belong to the simulation. Physical rovers stay connected.
+    // Take a copy of the names because stopRoverNode forgets each rover it stops.
+    set<string> rover_names_copy = sim_mgr.simulatedRoverNames();
 
+    // Each rover gets one signal and all of them shut down at the same time
     for(set<string>::const_iterator i = rover_names_copy.begin(); i != rover_names_copy.end(); ++i)
     {
         return_msg += sim_mgr.stopRoverNode(QString::fromStdString(*i));
         return_msg += "<br>";
-        progress_dialog.setValue((++count)*100.0f/rover_names_copy.size());
-        qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
     }
 
-    // Unsubscribe from topics
-
-    displayLogMessage("Shutting down subscribers...");
-
-    for (map<string,ros::Subscriber>::iterator it=encoder_subscribers.begin(); it!=encoder_subscribers.end(); ++it) it->second.shutdown();
-    encoder_subscribers.clear();
-    for (map<string,ros::Subscriber>::iterator it=gps_subscribers.begin(); it!=gps_subscribers.end(); ++it) it->second.shutdown();
-    gps_subscribers.clear();
-    for (map<string,ros::Subscriber>::iterator it=ekf_subscribers.begin(); it!=ekf_subscribers.end(); ++it) it->second.shutdown();
-    ekf_subscribers.clear();
-    us_center_subscriber.shutdown();
-    us_left_subscriber.shutdown();
-    us_right_subscriber.shutdown();
-    imu_subscriber.shutdown();
-
-    // Possible error - the following seems to shutdown all subscribers not just those from simulation
-
-    for (map<string,ros::Subscriber>::iterator it=status_subscribers.begin(); it!=status_subscribers.end(); ++it) it->second.shutdown();
-    status_subscribers.clear();
-
-    for (map<string,ros::Subscriber>::iterator it=obstacle_subscribers.begin(); it!=obstacle_subscribers.end(); ++it) it->second.shutdown();
-    obstacle_subscribers.clear();
-
-    for (map<string,ros::Subscriber>::iterator it=targetPickUpSubscribers.begin(); it!=targetPickUpSubscribers.end(); ++it) it->second.shutdown();
-    targetPickUpSubscribers.clear();
-
-    for (map<string,ros::Subscriber>::iterator it=targetDropOffSubscribers.begin(); it!=targetDropOffSubscribers.end(); ++it) it->second.shutdown();
-    targetDropOffSubscribers.clear();
-    camera_subscriber.shutdown();
-
-    displayLogMessage("Shutting down publishers...");
+    int stopping_count = sim_mgr.runningRoverNodeCount();
+    ros::WallTime stop_start = ros::WallTime::now();
+    // The supervisor kills anything still running after its 20 s grace period, so waiting a little longer sees every exit
+    while (sim_mgr.runningRoverNodeCount() > 0 && (ros::WallTime::now() - stop_start).toSec() < 22)
+    {
+        progress_dialog.setValue((stopping_count - sim_mgr.runningRoverNodeCount())*100.0f/stopping_count);
+        qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
+        ros::WallDuration(0.05).sleep();
+    }
+    return_msg += sim_mgr.collectRoverNodeExits();
+    return_msg += "<br>";
 
-    for (map<string,ros::Publisher>::iterator it=control_mode_publishers.begin(); it!=control_mode_publishers.end(); ++it) it->second.shutdown();
-    control_mode_publishers.clear();
+    // removeRover also shuts down the subscribers and publishers if the selected rover was simulated
+    for(set<string>::const_iterator i = rover_names_copy.begin(); i != rover_names_copy.end(); ++i)
+    {
+        rover_membership.remove(*i);
+        removeRover(*i);
+    }
 
     return_msg += sim_mgr.stopGazeboClient();
     return_msg += "<br>";
@@ -1250,8 +1066,7 @@ void RoverGUIPlugin::clearSimulationButtonEventHandler()
     // Clear the task status values
     ui.num_targets_collected_label->setText("<font color='white'>0</font>");
     ui.num_targets_detected_label->setText("<font color='white'>0</font>");
-    targetsPickedUp.clear();
-    targetsDroppedOff.clear();
+    target_scorer.reset();
     obstacle_call_count = 0;
     emit updateObstacleCallCount("<font color='white'>0</font>");
  }
@@ -1327,188 +1142,82 @@ QString RoverGUIPlugin::stopROSJoyNode()
     }
 }
 
-QString RoverGUIPlugin::addUniformTargets()
-{
-    QProgressDialog progress_dialog;
-    progress_dialog.setWindowTitle("Placing 256 Targets");
-    progress_dialog.setCancelButton(NULL); // no cancel button
-    progress_dialog.setWindowModality(Qt::ApplicationModal);
-    progress_dialog.resize(500, 50);
-    progress_dialog.setWindowFlags(progress_dialog.windowFlags() | Qt::WindowStaysOnTopHint);
-    progress_dialog.show();
-
-    QString output;
-
-    float proposed_x;
-    float proposed_y;
-
-    // 256 piles of 1 tag
-
-    // d is the distance from the center of the arena to the boundary minus the barrier clearance, i.e. the region where tags can be placed
-    // is d - U(0,2d) where U(a,b) is a uniform distribition bounded by a and b.
-    // (before checking for collisions including the collection disk at the center)
-    float d = arena_dim/2.0-(barrier_clearance+target_cluster_size_1_clearance);
-
-    for (int i = 0; i < 256; i++)
-    {
-        qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-        do
-        {
-            displayLogMessage("Tried to place target "+QString::number(i)+" at " + QString::number(proposed_x) + " " + QString::number(proposed_y) + "...");
-            proposed_x = d - ((float) rand()) / RAND_MAX*2*d;
-            proposed_y = d - ((float) rand()) / RAND_MAX*2*d;
-       }
-       while (sim_mgr.isLocationOccupied(proposed_x, proposed_y, target_cluster_size_1_clearance));
-       displayLogMessage("<font color=green>Succeeded.</font>");
-
-        output = sim_mgr.addModel(QString("at")+QString::number(i),  QString("at")+QString::number(i), proposed_x, proposed_y, 0, target_cluster_size_1_clearance);
-
-       progress_dialog.setValue(i*100.0f/256);
-       qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-    }
-    displayLogMessage("Placed 256 single targets");
-
-    return output;
-}
-
-QString RoverGUIPlugin::addClusteredTargets()
+// Waits until every rover has announced itself on the registry topic, its roslaunch has exited, or timeout seconds
+// have passed. The dialog shows the state of each rover. Returns the rovers that did not come up.
+QStringList RoverGUIPlugin::waitForRoverNodes(const QStringList& rover_names, double timeout, QProgressDialog& progress_dialog)
 {
-    QProgressDialog progress_dialog;
-    progress_dialog.setWindowTitle("Placing 256 Targets into 4 Clusters (64 targets each)");
-    progress_dialog.setCancelButton(NULL); // no cancel button
-    progress_dialog.setWindowModality(Qt::ApplicationModal);
-    progress_dialog.setWindowFlags(progress_dialog.windowFlags() | Qt::WindowStaysOnTopHint);
-    progress_dialog.resize(500, 50);
-    progress_dialog.show();
-
-    QString output;
-
-    float proposed_x;
-    float proposed_y;
+    QStringList pending = rover_names;
+    QStringList running;
+    QStringList failed;
 
-    float d = arena_dim/2.0-(barrier_clearance+target_cluster_size_64_clearance);
-
-    // Four piles of 64
-    for (int i = 0; i < 4; i++)
+    ros::WallTime start = ros::WallTime::now();
+    while (!pending.isEmpty() && (ros::WallTime::now() - start).toSec() < timeout)
     {
-        // Keep GUI responsive
         qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
 
-        do
+        for (int i = pending.size() - 1; i >= 0; i--)
         {
-            displayLogMessage("Tried to place cluster "+QString::number(i)+" at " + QString::number(proposed_x) + " " + QString::number(proposed_y));
-            proposed_x = d - ((float) rand()) / RAND_MAX*2*d;
-            proposed_y = d - ((float) rand()) / RAND_MAX*2*d;
+            if (rover_membership.isMember(pending[i].toStdString()))
+            {
+                displayLogMessage(pending[i] + " is running after " + QString::number((ros::WallTime::now() - start).toSec(), 'f', 1) + " seconds");
+                running << pending.takeAt(i);
+            }
+            else if (!sim_mgr.isRoverNodeRunning(pending[i]))
+            {
+                displayLogMessage("<font color='red'>The launch file for " + pending[i] + " exited before the rover started</font>");
+                failed << pending.takeAt(i);
+            }
         }
-        while (sim_mgr.isLocationOccupied(proposed_x, proposed_y, target_cluster_size_64_clearance));
-        displayLogMessage("<font color=green>Succeeded.</font>");
 
-        progress_dialog.setValue(i*100.0f/4);
-        qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
+        QString status;
+        for (int i = 0; i < rover_names.size(); i++)
+        {
+            if (running.contains(rover_names[i])) status += rover_names[i] + ": running\n";
+            else if (failed.contains(rover_names[i])) status += rover_names[i] + ": failed\n";
+            else status += rover_names[i] + ": starting\n";
+        }
+        progress_dialog.setLabelText(status.trimmed());
+        progress_dialog.setValue((running.size() + failed.size())*100.0f/rover_names.size());
 
-        output = sim_mgr.addModel(QString("atags64_")+QString::number(i), QString("atags64_")+QString::number(i), proposed_x, proposed_y, 0, target_cluster_size_64_clearance);
-        displayLogMessage(output);
+        ros::WallDuration(0.05).sleep();
     }
 
-    displayLogMessage("Placed four clusters of 64 targets");
-
-    return output;
+    return failed + pending;
 }
 
-QString RoverGUIPlugin::addPowerLawTargets()
+// Places the targets with the layout generator. The seed is logged so the same layout can be rebuilt
+// with "rosrun sim_layout generate_layouts --seed N".
+QString RoverGUIPlugin::addTargets(sim_layout::Distribution distribution, int n_rovers)
 {
-    QProgressDialog progress_dialog;
-    progress_dialog.setWindowTitle("Placing 256 Targets into 85 Clusters (Power Law pattern)");
-    progress_dialog.setCancelButton(NULL); // no cancel button
-    progress_dialog.setWindowModality(Qt::ApplicationModal);
-    progress_dialog.setWindowFlags(progress_dialog.windowFlags() | Qt::WindowStaysOnTopHint);
-    progress_dialog.resize(500, 50);
-    progress_dialog.show();
-
-
-    float total_number_of_clusters = 85;
-    float clusters_placed = 0;
-
-    QString output = "";
-    // One pile of 64
-
-    float proposed_x;
-    float proposed_y;
-
-    float d = arena_dim/2.0-(barrier_clearance+target_cluster_size_64_clearance);
-
-    do
+    sim_layout::LayoutParameters parameters;
+    parameters.arena_dim = arena_dim;
+    parameters.barrier_clearance = barrier_clearance;
+    parameters.cluster_size_64_clearance = target_cluster_size_64_clearance;
+    parameters.cluster_size_16_clearance = target_cluster_size_16_clearance;
+    parameters.cluster_size_4_clearance = target_cluster_size_4_clearance;
+    parameters.cluster_size_1_clearance = target_cluster_size_1_clearance;
+    parameters.reserveStartingArea(n_rovers);
+
+    uint32_t seed = QDateTime::currentMSecsSinceEpoch();
+    sim_layout::TargetLayout layout = sim_layout::TargetLayoutGenerator(parameters).generate(distribution, seed);
+
+    displayLogMessage("Generated " + QString(sim_layout::distributionName(distribution)) + " target layout with seed " + QString::number(layout.seed)
+                      + ": " + QString::number(layout.proposals) + " locations proposed, " + QString::number(layout.rejections) + " rejected");
+
+    if (!layout.complete)
     {
-        displayLogMessage("Tried to place cluster "+QString::number(clusters_placed)+" at " + QString::number(proposed_x) + " " + QString::number(proposed_y));
-        proposed_x = d - ((float) rand()) / RAND_MAX*2*d;
-        proposed_y = d - ((float) rand()) / RAND_MAX*2*d;
+        return "<br><font color='red'>Target placement failed: " + QString::fromStdString(layout.error) + "</font><br>";
     }
-    while (sim_mgr.isLocationOccupied(proposed_x, proposed_y, target_cluster_size_64_clearance));
-    displayLogMessage("<font color=green>Succeeded.</font>");
-
-    progress_dialog.setValue(clusters_placed++*100.0f/total_number_of_clusters);
-    output+= sim_mgr.addModel("atags64_0", "atags64_0", proposed_x, proposed_y, 0, target_cluster_size_64_clearance);
 
-    d = arena_dim/2.0-(barrier_clearance+target_cluster_size_16_clearance);
-
-    // Four piles of 16
-    for (int i = 0; i < 4; i++)
+    for (size_t i = 0; i < layout.targets.size(); i++)
     {
-        qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-        do
-        {
-            proposed_x = d - ((float) rand()) / RAND_MAX*2*d;
-            proposed_y = d - ((float) rand()) / RAND_MAX*2*d;
-            displayLogMessage("Tried to place cluster "+QString::number(clusters_placed)+" at " + QString::number(proposed_x) + " " + QString::number(proposed_y));
-        }
-        while (sim_mgr.isLocationOccupied(proposed_x, proposed_y, target_cluster_size_16_clearance));
-        displayLogMessage("<font color=green>Succeeded.</font>");
-
-
-        progress_dialog.setValue(clusters_placed++*100.0f/total_number_of_clusters);
-        qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-        output+= sim_mgr.addModel(QString("atags16_")+QString::number(i), QString("atags16_")+QString::number(i), proposed_x, proposed_y, 0, target_cluster_size_64_clearance);
+        const sim_layout::PlacedTarget& target = layout.targets[i];
+        sim_mgr.queueModel(QString::fromStdString(target.model_name), QString::fromStdString(target.unique_id), target.x, target.y, 0, target.clearance);
     }
 
-    d = arena_dim/2.0-(barrier_clearance+target_cluster_size_4_clearance);
-
-    // Sixteen piles of 4
-    for (int i = 0; i < 16; i++)
-    {
-        qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-        do
-        {
-            displayLogMessage("Tried to place cluster "+QString::number(clusters_placed)+" at " + QString::number(proposed_x) + " " + QString::number(proposed_y));
-            proposed_x = d - ((float) rand()) / RAND_MAX*2*d;
-            proposed_y = d - ((float) rand()) / RAND_MAX*2*d;
-        }
-        while (sim_mgr.isLocationOccupied(proposed_x, proposed_y, target_cluster_size_4_clearance));
-        displayLogMessage("<font color=green>Succeeded.</font>");
-
-        progress_dialog.setValue(clusters_placed++*100.0f/total_number_of_clusters);
-        qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-        output+= sim_mgr.addModel(QString("atags4_")+QString::number(i), QString("atags4_")+QString::number(i), proposed_x, proposed_y, 0, target_cluster_size_4_clearance);
-    }
-
-    d = arena_dim/2.0-(barrier_clearance+target_cluster_size_1_clearance);
-
-    // Sixty-four piles of 1 (using tags 192 through 255 to avoid duplication with piles above)
-    for (int i = 192; i < 256; i++)
-    {
-        qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-        do
-        {
-            displayLogMessage("Tried to place target "+QString::number(clusters_placed)+" at " + QString::number(proposed_x) + " " + QString::number(proposed_y));
-            proposed_x = d - ((float) rand()) / RAND_MAX*2*d;
-            proposed_y = d - ((float) rand()) / RAND_MAX*2*d;
-        }
-        while (sim_mgr.isLocationOccupied(proposed_x, proposed_y, target_cluster_size_1_clearance));
-        displayLogMessage("<font color=green>Succeeded.</font>");
-
-        progress_dialog.setValue(clusters_placed++*100.0f/total_number_of_clusters);
-        qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-        output+= sim_mgr.addModel(QString("at")+QString::number(i), QString("at")+QString::number(i), proposed_x, proposed_y, 0, target_cluster_size_1_clearance);
-    }
+    // Spawning is pipelined when the simulation is already running. Wait for gazebo to finish.
+    QString output = sim_mgr.waitForQueuedModels();
+    output += "<br><font color='yellow'>Placed " + QString::number(layout.targets.size()) + " target models</font><br>";
 
     return output;
 }
@@ -1578,64 +1287,6 @@ QString RoverGUIPlugin::addPrelimsWalls()
    return output;
 }
 
-int RoverGUIPlugin::targetDetect(const sensor_msgs::ImageConstPtr& rawImage) {
-
-    cv_bridge::CvImagePtr cvImage;
-
-	//Convert from MONO8 to BGR8
-	//TODO: consider whether we should let the camera publish as BGR8 and skip this conversion
-    try {
-        cvImage = cv_bridge::toCvCopy(rawImage); //, sensor_msgs::image_encodings::MONO8);
-    } catch (cv_bridge::Exception& e) {
-        ROS_ERROR("Could not convert from '%s' to 'bgr8'.", rawImage->encoding.c_str());
-        return -1;
-    }
-
-    //Create Mat image for processing
-    cv::Mat matImage = cvImage->image;
-    cv::cvtColor(matImage, matImage, cv::COLOR_BGR2GRAY);
-
-    //Force greyscale and force image size.  This is only for Gazebo.
-    //TODO: fix model so Gazebo publishes the correct format
-    //TODO: if Mat is only used here, why not use the cvImage format here and skip the Mat image completely?
-    if (matImage.cols != 320 && matImage.rows != 240) {
-        cv::resize(matImage, matImage, cv::Size(320, 240), cv::INTER_LINEAR);
-    }
-
-    //Copy all image data into an array that AprilTag library expects
-    image_u8_t *im = copy_image_data_into_u8_container(	matImage.cols, 
-							matImage.rows, 
-							(uint8_t *) matImage.data, 
-							matImage.step);
-
-    //Detect AprilTags
-    zarray_t *detections = apriltag_detector_detect(td, im);
-    
-    //Check result for valid tag
-    for (int i = 0; i < zarray_size(detections); i++) {
-	    apriltag_detection_t *det;
-	    zarray_get(detections, i, &det);
-	
-	    int tag = det->id;
-	    
-	    //Return first tag that has not been collected
-	    if (targetsDroppedOff.count(tag) == 0){
-			return tag;
-		}
-	}
-	
-	return -1;
-}
-
-image_u8_t* RoverGUIPlugin::copy_image_data_into_u8_container(int width, int height, uint8_t *rgb, int stride) {
-    for (int y = 0; y < u8_image->height; y++) {
-        for (int x = 0; x < u8_image->width; x++) {
-            u8_image->buf[y * u8_image->stride + x] = rgb[y * stride + x + 0];
-        }
-    }
-    return u8_image;
-}
-
 void RoverGUIPlugin::checkAndRepositionRover(QString rover_name, float x, float y)
 {
     // Currently disabled.
@@ -1656,20 +1307,11 @@ void RoverGUIPlugin::checkAndRepositionRover(QString rover_name, float x, float
     }
 }
 
-void RoverGUIPlugin::readRoverModelXML(QString path)
+void RoverGUIPlugin::readRoverModelXML(const string& sdf)
 {
-    ifstream model_file;
-    model_file.open(path.toStdString(), ios::in);
-    if (model_file.is_open())
-        displayLogMessage("Read model file at " + path );
-    else
-    {
-        displayLogMessage(QString::fromStdString(selected_rover_name) + " appears to be a physical rover.");
-        return;
-    }
-
+    istringstream model_stream(sdf);
     ptree property_tree;
-    read_xml(model_file, property_tree);
+    read_xml(model_stream, property_tree);
 
     BOOST_FOREACH( ptree::value_type const& v, property_tree.get_child("sdf.model") )
     {
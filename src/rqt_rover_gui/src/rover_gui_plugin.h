@@ -40,6 +40,8 @@
 #include <QEvent>
 #include <QKeyEvent>
 #include <QProcess>
+#include <QProgressDialog>
+#include <QStringList>
 
 #include <map>
 #include <set>
@@ -53,18 +55,16 @@
 #include <QLabel>
 
 #include "GazeboSimManager.h"
+#include <sim_layout/Arena.h>
+#include <sim_layout/Rovers.h>
+#include <sim_layout/TargetLayout.h>
+#include "RoverMembership.h"
+#include "RoverConnection.h"
+#include "TargetScorer.h"
 
-//AprilTag headers
-#include "apriltag.h"
-#include "tag36h11.h"
-#include "tag36h10.h"
-#include "tag36artoolkit.h"
-#include "tag25h9.h"
-#include "tag25h7.h"
-#include "common/pnm.h"
-#include "common/image_u8.h"
-#include "common/zarray.h"
-#include "common/getopt.h"
+#include <boost/shared_ptr.hpp>
+
+#include <shared_messages/RoverHeartbeat.h>
 
 using namespace std;
 
@@ -87,7 +87,6 @@ namespace rqt_rover_gui {
     QString startROSJoyNode();
     QString stopROSJoyNode();
 
-    void statusEventHandler(const ros::MessageEvent<std_msgs::String const>& event);
     void joyEventHandler(const sensor_msgs::Joy::ConstPtr& joy_msg);
     void cameraEventHandler(const sensor_msgs::ImageConstPtr& image);
     void EKFEventHandler(const ros::MessageEvent<const nav_msgs::Odometry> &event);
@@ -96,6 +95,7 @@ namespace rqt_rover_gui {
     void targetPickUpEventHandler(const ros::MessageEvent<const sensor_msgs::Image> &event);
     void targetDropOffEventHandler(const ros::MessageEvent<const sensor_msgs::Image> &event);
     void obstacleEventHandler(const ros::MessageEvent<std_msgs::UInt8 const>& event);
+    void roverHeartbeatEventHandler(const shared_messages::RoverHeartbeat::ConstPtr& msg);
 
     void centerUSEventHandler(const sensor_msgs::Range::ConstPtr& msg);
     void leftUSEventHandler(const sensor_msgs::Range::ConstPtr& msg);
@@ -103,11 +103,10 @@ namespace rqt_rover_gui {
     void IMUEventHandler(const sensor_msgs::Imu::ConstPtr& msg);
 
     void addModelToGazebo();
-    QString addPowerLawTargets();
-    QString addUniformTargets();
-    QString addClusteredTargets();
+    QString addTargets(sim_layout::Distribution distribution, int n_rovers);
     QString addFinalsWalls();
     QString addPrelimsWalls();
+    QStringList waitForRoverNodes(const QStringList& rover_names, double timeout, QProgressDialog& progress_dialog);
 
 
    // void targetDetectedEventHandler( rover_onboard_target_detection::ATag tagInfo ); //rover_onboard_target_detection::ATag msg );
@@ -115,15 +114,6 @@ namespace rqt_rover_gui {
     void setupSubscribers();
     void setupPublishers();
 
-    // Detect rovers that are broadcasting information
-    set<string> findConnectedRovers();
-    
-    //Image converter
-	image_u8_t *copy_image_data_into_u8_container(int width, int height, uint8_t *rgb, int stride);
-
-	//AprilTag detector
-	int targetDetect(const sensor_msgs::ImageConstPtr& rawImage);
-
   signals:
 
     void joystickForwardUpdate(double);
@@ -132,11 +122,12 @@ namespace rqt_rover_gui {
     void joystickRightUpdate(double);
     void updateObstacleCallCount(QString text);
     void updateLog(QString text);
+    void roverMembershipChanged();
 
   private slots:
 
     void currentRoverChangedEventHandler(QListWidgetItem *current, QListWidgetItem *previous);
-    void pollRoversTimerEventHandler();
+    void updateRoverMembershipEventHandler();
     void GPSCheckboxToggledEventHandler(bool checked);
     void EKFCheckboxToggledEventHandler(bool checked);
     void encoderCheckboxToggledEventHandler(bool checked);
@@ -159,47 +150,47 @@ namespace rqt_rover_gui {
   private:
 
     void checkAndRepositionRover(QString rover_name, float x, float y);
-    void readRoverModelXML(QString path);
+    void readRoverModelXML(const string& sdf);
+
+    // Create and tear down the publishers, subscribers, and list entry of a single rover
+    void addRover(const string& rover_name);
+    void removeRover(const string& rover_name);
+
+    // Safe to call from the ROS callback thread. Returns a null pointer if the rover is not connected.
+    boost::shared_ptr<RoverConnection> findRoverConnection(const string& rover_name);
 
-    map<string,ros::Publisher> control_mode_publishers;
     ros::Publisher joystick_publisher;
-    map<string,ros::Publisher> targetPickUpPublisher;
-    map<string,ros::Publisher> targetDropOffPublisher;
 
     ros::Subscriber joystick_subscriber;
-    map<string,ros::Subscriber> encoder_subscribers;
-    map<string,ros::Subscriber> gps_subscribers;
-    map<string,ros::Subscriber> ekf_subscribers;
+    ros::Subscriber rover_registry_subscriber;
     ros::Subscriber us_center_subscriber;
     ros::Subscriber us_left_subscriber;
     ros::Subscriber us_right_subscriber;
     ros::Subscriber imu_subscriber;
 
-    map<string,ros::Subscriber> status_subscribers;
-    map<string,ros::Subscriber> obstacle_subscribers;
-    map<string,ros::Subscriber> targetDropOffSubscribers;
-    map<string,ros::Subscriber> targetPickUpSubscribers;
     image_transport::Subscriber camera_subscriber;
 
     string selected_rover_name;
-    set<string> rover_names;
+    // One connection per rover, keyed by rover name. The GUI thread adds and removes connections,
+    // the ROS callbacks look them up, so the map is guarded by a mutex.
+    map<string, boost::shared_ptr<RoverConnection> > rover_connections;
+    QMutex rover_connections_mutex;
     ros::NodeHandle nh;
     QWidget* widget;
     Ui::RoverGUI ui;
 
     QProcess* joy_process;
-    QTimer* rover_poll_timer; // for rover polling
+    QTimer* rover_membership_timer; // for rover heartbeat timeouts and status updates
+    RoverMembership rover_membership;
 
     QString log_messages;
     GazeboSimManager sim_mgr;
 
     map<string,int> rover_control_state;
-    map<string,string> rover_statuses;
 
     float arena_dim; // in meters
 
-    map<string,int> targetsPickedUp;
-    map<int,bool> targetsDroppedOff;
+    TargetScorer target_scorer;
 
     bool display_sim_visualization;
 
@@ -213,16 +204,6 @@ namespace rqt_rover_gui {
     float barrier_clearance;
 
     unsigned long obstacle_call_count;
-    
-    //AprilTag objects
-	apriltag_family_t *tf = NULL; //tag family
-	apriltag_detector_t *td = NULL; //tag detector
-
-	//Image container
-	image_u8_t *u8_image = NULL;
-	
-	//AprilTag assigned to collection zone
-	int collectionZoneID = 256;
   };
 } // end namespace
 
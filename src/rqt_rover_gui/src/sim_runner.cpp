@@ -0,0 +1,449 @@
+// Headless batch experiment runner. Runs one simulation trial per seed without the GUI or gzclient:
+//
+//   1. writes a world file with the arena, rovers and the seeded target layout (sim_layout)
+//   2. starts a private roscore and gzserver on ports reserved for the trial's slot
+//   3. launches the rover nodes
+//   4. runs trial_monitor, which drives and scores the trial for a fixed simulated time
+//   5. stops every process the trial started, including the nodes roslaunch runs in sessions of their own, and
+//      appends the monitor's result line to the results file
+//
+// Several trials can run at once: each slot has its own ROS and gazebo master ports, ROS_HOME and log directory.
+//
+//   rosrun rqt_rover_gui sim_runner --distribution powerlaw --seed 100 --count 200 --parallel 4 --duration 900
+//
+// Needs the same environment as run.sh: SWARMATHON_APP_ROOT, the workspace's setup.bash sourced, and
+// GAZEBO_MODEL_PATH / GAZEBO_PLUGIN_PATH (set from SWARMATHON_APP_ROOT if missing).
+
+#include <sim_layout/Arena.h>
+#include <sim_layout/Rovers.h>
+#include <sim_layout/Tags.h>
+#include <sim_layout/TargetLayout.h>
+#include <sim_layout/WorldFile.h>
+#include "ProcessTree.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct RunnerOptions
+{
+    sim_layout::Distribution distribution;
+    unsigned long first_seed;
+    unsigned long count;
+    int parallel;
+    double duration;    // simulated seconds per trial
+    double wall_limit;  // wall clock seconds before a trial is abandoned
+    bool final_round;
+    int n_rovers;
+    string ground_plane;
+    string physics_profile;
+    bool image_scoring; // score with AprilTag detection in trial_monitor instead of the ScoringPlugin
+    bool tag_camera;    // synthetic tag detections from the TagCameraPlugin instead of rendered cameras
+    string app_root;
+    string work_dir;
+    string output_path;
+};
+
+static const int ROS_BASE_PORT = 11411;
+static const int GAZEBO_BASE_PORT = 11511;
+
+// Set by SIGINT or SIGTERM. Running trials stop their processes and no new trials are started.
+static volatile sig_atomic_t interrupted = 0;
+
+static void interruptHandler(int)
+{
+    interrupted = 1;
+}
+
+static double wallSeconds()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec*1e-9;
+}
+
+// Starts command with sh in process group group (0 starts a new group led by the new process).
+// stdout and stderr go to log_path.
+static pid_t spawn(const string& command, const string& log_path, pid_t group)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        setpgid(0, group);
+
+        int log = open(log_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (log >= 0)
+        {
+            dup2(log, STDOUT_FILENO);
+            dup2(log, STDERR_FILENO);
+            close(log);
+        }
+
+        execl("/bin/sh", "sh", "-c", command.c_str(), (char*)NULL);
+        _exit(127);
+    }
+
+    // Also set from the parent so the group exists before spawn() returns
+    if (pid > 0) setpgid(pid, group == 0 ? pid : group);
+    return pid;
+}
+
+// Waits up to timeout seconds for pid to exit. Returns false if it is still running.
+static bool waitFor(pid_t pid, double timeout, int& status)
+{
+    double deadline = wallSeconds() + timeout;
+    while (true)
+    {
+        pid_t result = waitpid(pid, &status, WNOHANG);
+        if (result == pid) return true;
+        if (result < 0) return errno == ECHILD;
+        if (wallSeconds() > deadline || interrupted) return false;
+        usleep(100000);
+    }
+}
+
+// Runs command to completion in group and returns true if it exited with status 0
+static bool run(const string& command, const string& log_path, pid_t group, double timeout)
+{
+    pid_t pid = spawn(command, log_path, group);
+    if (pid < 0) return false;
+
+    int status = 0;
+    if (!waitFor(pid, timeout, status))
+    {
+        kill(pid, SIGKILL);
+        waitpid(pid, &status, 0);
+        return false;
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// roslaunch starts rosmaster, rosout and every rover node in a session of its own, so they are not in group and
+// a signal to the group never reaches them. They are found through their parents before anything is stopped, and
+// everything gets SIGINT at once. roslaunch escalates to SIGTERM and SIGKILL by itself after about 17 s, so only
+// what is still running after 20 s is killed here.
+static void stopGroup(pid_t group)
+{
+    vector<ProcessTree::TrackedProcess> processes;
+    ProcessTree().collect(group, processes);
+
+    kill(-group, SIGINT);
+    ProcessTree::signal(processes, SIGINT);
+
+    bool children_reaped = false;
+    double deadline = wallSeconds() + 20;
+    while (wallSeconds() < deadline)
+    {
+        while (!children_reaped)
+        {
+            int status;
+            pid_t result = waitpid(-group, &status, WNOHANG);
+            if (result < 0 && errno == ECHILD) children_reaped = true;
+            if (result == 0) break;
+        }
+
+        ProcessTree::prune(processes);
+        if (children_reaped && processes.empty()) return;
+        usleep(100000);
+    }
+
+    kill(-group, SIGKILL);
+    ProcessTree::signal(processes, SIGKILL);
+    while (waitpid(-group, NULL, 0) > 0) {}
+}
+
+// Runs in its own process. Returns the exit status for the trial.
+static int runTrial(const RunnerOptions& options, unsigned long seed, int slot)
+{
+    ostringstream trial_name;
+    trial_name << sim_layout::distributionName(options.distribution) << "_" << seed;
+    string trial_dir = options.work_dir + "/" + trial_name.str();
+    mkdir(trial_dir.c_str(), 0755);
+    string log = trial_dir + "/trial.log";
+
+    int n_rovers = options.n_rovers;
+    float arena_dim = options.final_round ? sim_layout::FINAL_ARENA_DIM : sim_layout::PRELIM_ARENA_DIM;
+
+    // Build the world
+    sim_layout::LayoutParameters parameters;
+    parameters.arena_dim = arena_dim;
+    parameters.reserveStartingArea(n_rovers);
+    sim_layout::TargetLayout layout = sim_layout::TargetLayoutGenerator(parameters).generate(options.distribution, seed);
+    if (!layout.complete)
+    {
+        cerr << trial_name.str() << ": " << layout.error << endl;
+        return 1;
+    }
+
+    string rover_template, tag_template;
+    string error;
+    if (!sim_layout::loadModelTemplate(options.app_root + "/" + sim_layout::ROVER_TEMPLATE_PATH, rover_template, error) ||
+        !sim_layout::loadModelTemplate(options.app_root + "/" + sim_layout::TAG_TEMPLATE_PATH, tag_template, error))
+    {
+        cerr << trial_name.str() << ": " << error << endl;
+        return 1;
+    }
+
+    vector<sim_layout::WorldModel> models;
+    sim_layout::appendArena(options.final_round, options.ground_plane, models);
+    sim_layout::appendRovers(rover_template, n_rovers, models);
+    sim_layout::appendTargets(tag_template, layout, models);
+
+    string world_path = trial_dir + "/trial.world";
+    if (!sim_layout::writeWorldFile(options.app_root + "/simulation/worlds/swarmathon.world", models, world_path, error, options.physics_profile,
+                                    !options.image_scoring, options.tag_camera))
+    {
+        cerr << trial_name.str() << ": " << error << endl;
+        return 1;
+    }
+
+    // Private masters for this slot. Everything started below inherits the environment.
+    ostringstream ros_master, gazebo_master;
+    ros_master << "http://localhost:" << ROS_BASE_PORT + slot;
+    gazebo_master << "http://localhost:" << GAZEBO_BASE_PORT + slot;
+    setenv("ROS_MASTER_URI", ros_master.str().c_str(), 1);
+    setenv("GAZEBO_MASTER_URI", gazebo_master.str().c_str(), 1);
+    setenv("ROS_HOME", trial_dir.c_str(), 1);
+    setenv("ROS_LOG_DIR", trial_dir.c_str(), 1);
+
+    ostringstream roscore;
+    roscore << "roscore -p " << ROS_BASE_PORT + slot;
+    pid_t group = spawn(roscore.str(), trial_dir + "/roscore.log", 0);
+    if (group < 0) return 1;
+
+    int result = 1;
+    string result_path = trial_dir + "/result.csv";
+    remove(result_path.c_str());
+
+    do
+    {
+        // Setting the parameter fails until the master is up. Rover nodes must see use_sim_time when they start.
+        bool master_up = false;
+        for (int attempt = 0; attempt < 60 && !master_up && !interrupted; attempt++)
+        {
+            master_up = run("rosparam set /use_sim_time true", log, group, 10);
+            if (!master_up) sleep(1);
+        }
+        if (!master_up)
+        {
+            cerr << trial_name.str() << ": roscore did not start" << endl;
+            break;
+        }
+
+        spawn("rosrun gazebo_ros gzserver " + world_path, trial_dir + "/gzserver.log", group);
+        if (!run("rosservice call --wait /gazebo/get_physics_properties", log, group, 120))
+        {
+            cerr << trial_name.str() << ": gzserver did not start" << endl;
+            break;
+        }
+
+        for (int i = 0; i < n_rovers; i++)
+        {
+            string name = sim_layout::roverName(i);
+            ostringstream launch;
+            launch << "roslaunch " << options.app_root << "/" << sim_layout::ROVER_LAUNCH_PATH
+                   << " name:=" << name << " swarm_index:=" << i << " swarm_size:=" << n_rovers;
+            spawn(launch.str(), trial_dir + "/" + name + ".log", group);
+        }
+
+        ostringstream monitor;
+        monitor << "rosrun rqt_rover_gui trial_monitor"
+                << " _rover_count:=" << n_rovers << " _duration:=" << options.duration << " _arena_dim:=" << arena_dim
+                << " _output:=" << result_path << " _label:=" << sim_layout::distributionName(options.distribution) << "," << seed
+                << " _plugin_scoring:=" << (options.image_scoring ? "false" : "true");
+        if (!run(monitor.str(), trial_dir + "/trial_monitor.log", group, options.wall_limit))
+        {
+            cerr << trial_name.str() << ": trial did not finish within " << options.wall_limit << " wall clock seconds" << endl;
+            break;
+        }
+
+        result = 0;
+    }
+    while (false);
+
+    stopGroup(group);
+    return result;
+}
+
+static void printUsage(const char* program)
+{
+    cerr << "Usage: " << program << " [options]\n"
+         << "  --distribution NAME  uniform, clustered or powerlaw (default uniform)\n"
+         << "  --seed N             seed of the first trial (default 1)\n"
+         << "  --count N            number of trials, seeds N, N+1, ... (default 1)\n"
+         << "  --parallel N         trials to run at once (default 1)\n"
+         << "  --duration S         simulated seconds per trial (default 1800)\n"
+         << "  --wall-limit S       wall clock seconds before a trial is abandoned (default 3*duration+300)\n"
+         << "  --final              final round arena and six rovers\n"
+         << "  --rovers N           number of rovers, e.g. 12, 24 or 48 to test scaling (default 3, or 6 with --final)\n"
+         << "  --ground NAME        ground plane model (default mars_ground_plane)\n"
+         << "  --physics PROFILE    SetupWorld physics profile: default or fast (default fast)\n"
+         << "  --image-scoring      score pick ups from the rovers' camera images, as the GUI does, instead of\n"
+         << "                       from the target positions in gazebo\n"
+         << "  --tag-camera         replace the rendered rover cameras with synthetic tag detections\n"
+         << "  --work-dir DIR       trial worlds and logs (default /tmp/sim_runner)\n"
+         << "  --output PATH        results file (default sim_results.csv)\n";
+}
+
+int main(int argc, char** argv)
+{
+    RunnerOptions options;
+    options.distribution = sim_layout::UNIFORM;
+    options.first_seed = 1;
+    options.count = 1;
+    options.parallel = 1;
+    options.duration = 1800;
+    options.wall_limit = 0;
+    options.final_round = false;
+    options.n_rovers = 0;
+    options.ground_plane = "mars_ground_plane";
+    options.physics_profile = "fast";
+    options.image_scoring = false;
+    options.tag_camera = false;
+    options.work_dir = "/tmp/sim_runner";
+    options.output_path = "sim_results.csv";
+
+    for (int i = 1; i < argc; i++)
+    {
+        string option = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (option == "--distribution" && has_value)
+        {
+            if (!sim_layout::parseDistribution(argv[++i], options.distribution))
+            {
+                cerr << "Unknown distribution " << argv[i] << endl;
+                return 1;
+            }
+        }
+        else if (option == "--seed" && has_value) options.first_seed = strtoul(argv[++i], NULL, 10);
+        else if (option == "--count" && has_value) options.count = strtoul(argv[++i], NULL, 10);
+        else if (option == "--parallel" && has_value) options.parallel = max(1, atoi(argv[++i]));
+        else if (option == "--duration" && has_value) options.duration = atof(argv[++i]);
+        else if (option == "--wall-limit" && has_value) options.wall_limit = atof(argv[++i]);
+        else if (option == "--final") options.final_round = true;
+        else if (option == "--rovers" && has_value) options.n_rovers = atoi(argv[++i]);
+        else if (option == "--ground" && has_value) options.ground_plane = argv[++i];
+        else if (option == "--physics" && has_value) options.physics_profile = argv[++i];
+        else if (option == "--image-scoring") options.image_scoring = true;
+        else if (option == "--tag-camera") options.tag_camera = true;
+        else if (option == "--work-dir" && has_value) options.work_dir = argv[++i];
+        else if (option == "--output" && has_value) options.output_path = argv[++i];
+        else
+        {
+            printUsage(argv[0]);
+            return option == "--help" ? 0 : 1;
+        }
+    }
+
+    if (options.wall_limit <= 0) options.wall_limit = 3*options.duration + 300;
+    if (options.n_rovers <= 0) options.n_rovers = options.final_round ? sim_layout::FINAL_ROVERS : sim_layout::PRELIM_ROVERS;
+
+    // The synthetic camera publishes no images, so only the ScoringPlugin can answer the rovers
+    if (options.tag_camera && options.image_scoring)
+    {
+        cerr << "--tag-camera cannot be combined with --image-scoring" << endl;
+        return 1;
+    }
+
+    // No SA_RESTART, so waitpid() returns when interrupted
+    struct sigaction interrupt_action;
+    interrupt_action.sa_handler = interruptHandler;
+    sigemptyset(&interrupt_action.sa_mask);
+    interrupt_action.sa_flags = 0;
+    sigaction(SIGINT, &interrupt_action, NULL);
+    sigaction(SIGTERM, &interrupt_action, NULL);
+
+    const char* app_root = getenv("SWARMATHON_APP_ROOT");
+    if (!app_root)
+    {
+        cerr << "SWARMATHON_APP_ROOT is not set" << endl;
+        return 1;
+    }
+    options.app_root = app_root;
+    setenv("GAZEBO_MODEL_PATH", (options.app_root + "/simulation/models").c_str(), 0);
+    setenv("GAZEBO_PLUGIN_PATH", (options.app_root + "/build/gazebo_plugins").c_str(), 0);
+
+    mkdir(options.work_dir.c_str(), 0755);
+
+    ifstream existing(options.output_path.c_str());
+    bool write_header = !existing.good() || existing.peek() == ifstream::traits_type::eof();
+    existing.close();
+
+    ofstream results(options.output_path.c_str(), ios::app);
+    if (write_header)
+        results << "distribution,seed,rovers,sim_seconds,targets_collected,targets_carried,coverage,collision_events,obstacle_calls,failed_drop_offs,wall_seconds" << endl;
+
+    map<pid_t, pair<unsigned long, int> > running; // trial process -> seed, slot
+    map<pid_t, double> started;
+    vector<bool> slot_busy(options.parallel, false);
+    unsigned long next_trial = 0;
+    int failures = 0;
+
+    while ((next_trial < options.count && !interrupted) || !running.empty())
+    {
+        // Fill free slots
+        for (int slot = 0; slot < options.parallel && next_trial < options.count && !interrupted; slot++)
+        {
+            if (slot_busy[slot]) continue;
+
+            unsigned long seed = options.first_seed + next_trial++;
+            pid_t pid = fork();
+            if (pid == 0) _exit(runTrial(options, seed, slot));
+            if (pid < 0)
+            {
+                cerr << "Could not start trial " << seed << endl;
+                failures++;
+                continue;
+            }
+
+            slot_busy[slot] = true;
+            running[pid] = make_pair(seed, slot);
+            started[pid] = wallSeconds();
+            cout << "Started " << sim_layout::distributionName(options.distribution) << " seed " << seed << " in slot " << slot << endl;
+        }
+
+        int status;
+        pid_t finished = waitpid(-1, &status, 0);
+        if (finished < 0 || running.count(finished) == 0) continue;
+
+        unsigned long seed = running[finished].first;
+        slot_busy[running[finished].second] = false;
+        double wall_seconds = wallSeconds() - started[finished];
+        running.erase(finished);
+        started.erase(finished);
+
+        ostringstream result_path;
+        result_path << options.work_dir << "/" << sim_layout::distributionName(options.distribution) << "_" << seed << "/result.csv";
+        ifstream result_file(result_path.str().c_str());
+        string result;
+        getline(result_file, result);
+
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0 && !result.empty())
+        {
+            results << result << "," << wall_seconds << endl;
+            cout << "Finished seed " << seed << ": " << result << " in " << wall_seconds << " s" << endl;
+        }
+        else
+        {
+            failures++;
+            cout << "Seed " << seed << " failed, see " << options.work_dir << " for logs" << endl;
+        }
+    }
+
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,237 @@
+// Headless stand in for the GUI during a batch trial. Started by sim_runner once gazebo and the rovers are up.
+//
+// Switches the rovers to autonomous mode, answers their pick up and drop off requests with the same TargetScorer
+// the GUI uses, and collects metrics until the trial has run for ~duration seconds of simulated time. It then
+// appends one line to ~output and exits. With ~plugin_scoring the ScoringPlugin in gazebo answers the requests and
+// the monitor takes the score from its /score messages instead.
+//
+// Private parameters:
+//   ~rover_count   number of rovers, named by sim_layout::roverName(0), roverName(1), ... (default 3)
+//   ~duration      simulated seconds to run (default 1800)
+//   ~arena_dim     arena width in meters, used for coverage (default 15)
+//   ~output        file to append the result line to (default trial_results.csv)
+//   ~label         first column of the result line, e.g. "powerlaw,42" (default empty)
+//   ~plugin_scoring  leave scoring to the ScoringPlugin (default false)
+
+#include <ros/ros.h>
+#include <gazebo_msgs/ModelStates.h>
+#include <sensor_msgs/Image.h>
+#include <std_msgs/Int16.h>
+#include <std_msgs/UInt8.h>
+#include <shared_messages/TrialScore.h>
+#include <sim_layout/Arena.h>
+#include <sim_layout/Rovers.h>
+#include <boost/bind.hpp>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "TargetScorer.h"
+
+using namespace std;
+
+struct MonitoredRover
+{
+    ros::Publisher mode_publisher;
+    ros::Publisher target_pick_up_publisher;
+    ros::Publisher target_drop_off_publisher;
+    ros::Subscriber target_pick_up_subscriber;
+    ros::Subscriber target_drop_off_subscriber;
+    ros::Subscriber obstacle_subscriber;
+
+    unsigned long obstacle_calls;   // Every non zero obstacle message, the number the GUI shows
+    unsigned long collision_events; // Transitions from clear to obstacle
+    unsigned long failed_drop_offs;
+    bool obstacle_present;
+};
+
+TargetScorer target_scorer;
+map<string, MonitoredRover> rovers;
+
+bool plugin_scoring = false;
+shared_messages::TrialScore plugin_score; // Latest score from the ScoringPlugin
+
+// Coverage grid over the arena. A cell counts as covered once any rover's center has been in it.
+const float coverage_cell_size = 0.5; // meters
+float arena_dim = sim_layout::PRELIM_ARENA_DIM;
+int coverage_cells_per_side = 0;
+vector<bool> coverage;
+size_t covered_cells = 0;
+ros::Time last_coverage_update;
+
+ros::Time trial_start;
+ros::Duration trial_duration;
+
+void targetPickUpHandler(const string& rover_name, const sensor_msgs::ImageConstPtr& image)
+{
+    std_msgs::Int16 reply;
+    reply.data = target_scorer.pickUp(rover_name, image);
+    rovers[rover_name].target_pick_up_publisher.publish(reply);
+}
+
+void targetDropOffHandler(const string& rover_name, const sensor_msgs::ImageConstPtr& image)
+{
+    int target_id = -1;
+    std_msgs::Int16 reply;
+
+    switch (target_scorer.dropOff(rover_name, image, target_id))
+    {
+    case TargetScorer::NOT_AT_COLLECTION_ZONE:
+        return;
+
+    case TargetScorer::NOT_CARRYING:
+        rovers[rover_name].failed_drop_offs++;
+        reply.data = -1;
+        break;
+
+    case TargetScorer::DROPPED_OFF:
+        reply.data = TargetScorer::COLLECTION_ZONE_ID;
+        break;
+    }
+
+    rovers[rover_name].target_drop_off_publisher.publish(reply);
+}
+
+void obstacleHandler(const string& rover_name, const std_msgs::UInt8ConstPtr& message)
+{
+    MonitoredRover& rover = rovers[rover_name];
+
+    // 0 for no obstacle, 1 for right side obstacle, and 2 for left side obstacle
+    bool obstacle = message->data != 0;
+    if (obstacle) rover.obstacle_calls++;
+    if (obstacle && !rover.obstacle_present) rover.collision_events++;
+    rover.obstacle_present = obstacle;
+}
+
+void modelStatesHandler(const gazebo_msgs::ModelStatesConstPtr& states)
+{
+    // Gazebo publishes model states every physics step. Ten samples per simulated second are plenty for coverage.
+    ros::Time now = ros::Time::now();
+    if (now - last_coverage_update < ros::Duration(0.1)) return;
+    last_coverage_update = now;
+
+    for (size_t i = 0; i < states->name.size(); i++)
+    {
+        if (rovers.count(states->name[i]) == 0) continue;
+
+        int cell_x = floor((states->pose[i].position.x + arena_dim/2) / coverage_cell_size);
+        int cell_y = floor((states->pose[i].position.y + arena_dim/2) / coverage_cell_size);
+        if (cell_x < 0 || cell_y < 0 || cell_x >= coverage_cells_per_side || cell_y >= coverage_cells_per_side) continue;
+
+        size_t cell = cell_y * coverage_cells_per_side + cell_x;
+        if (!coverage[cell])
+        {
+            coverage[cell] = true;
+            covered_cells++;
+        }
+    }
+}
+
+void scoreHandler(const shared_messages::TrialScoreConstPtr& score)
+{
+    plugin_score = *score;
+}
+
+void writeResult(const string& output_path, const string& label)
+{
+    unsigned long obstacle_calls = 0;
+    unsigned long collision_events = 0;
+    unsigned long failed_drop_offs = 0;
+    for (map<string, MonitoredRover>::iterator it = rovers.begin(); it != rovers.end(); ++it)
+    {
+        obstacle_calls += it->second.obstacle_calls;
+        collision_events += it->second.collision_events;
+        failed_drop_offs += it->second.failed_drop_offs;
+    }
+
+    size_t collected = target_scorer.collectedCount();
+    size_t carried = target_scorer.carriedCount();
+    if (plugin_scoring)
+    {
+        collected = plugin_score.targets_collected;
+        carried = plugin_score.targets_carried;
+        failed_drop_offs = plugin_score.failed_drop_offs;
+    }
+
+    float coverage_fraction = (float)covered_cells / coverage.size();
+
+    // label,rovers,sim_seconds,targets_collected,targets_carried,coverage,collision_events,obstacle_calls,failed_drop_offs
+    ofstream output(output_path.c_str(), ios::app);
+    output << label << "," << rovers.size() << "," << (ros::Time::now() - trial_start).toSec() << ","
+           << collected << "," << carried << "," << coverage_fraction << ","
+           << collision_events << "," << obstacle_calls << "," << failed_drop_offs << endl;
+}
+
+int main(int argc, char** argv)
+{
+    ros::init(argc, argv, "trial_monitor");
+    ros::NodeHandle nh;
+    ros::NodeHandle private_nh("~");
+
+    int rover_count;
+    double duration;
+    string output_path;
+    string label;
+    private_nh.param("rover_count", rover_count, sim_layout::PRELIM_ROVERS);
+    private_nh.param("duration", duration, 1800.0);
+    private_nh.param("arena_dim", arena_dim, sim_layout::PRELIM_ARENA_DIM);
+    private_nh.param("output", output_path, string("trial_results.csv"));
+    private_nh.param("label", label, string(""));
+    private_nh.param("plugin_scoring", plugin_scoring, false);
+
+    coverage_cells_per_side = ceil(arena_dim / coverage_cell_size);
+    coverage.assign(coverage_cells_per_side * coverage_cells_per_side, false);
+
+    for (int i = 0; i < rover_count; i++)
+    {
+        string name = sim_layout::roverName(i);
+        MonitoredRover& rover = rovers[name];
+        rover.obstacle_calls = 0;
+        rover.collision_events = 0;
+        rover.failed_drop_offs = 0;
+        rover.obstacle_present = false;
+
+        // Latched like the GUI's publishers so rovers that subscribe late still get the mode
+        rover.mode_publisher = nh.advertise<std_msgs::UInt8>("/"+name+"/mode", 10, true);
+
+        if (!plugin_scoring)
+        {
+            rover.target_pick_up_publisher = nh.advertise<std_msgs::Int16>("/"+name+"/targetPickUpValue", 10, true);
+            rover.target_drop_off_publisher = nh.advertise<std_msgs::Int16>("/"+name+"/targetDropOffValue", 10, true);
+
+            rover.target_pick_up_subscriber = nh.subscribe<sensor_msgs::Image>("/"+name+"/targetPickUpImage", 10, boost::bind(targetPickUpHandler, name, _1));
+            rover.target_drop_off_subscriber = nh.subscribe<sensor_msgs::Image>("/"+name+"/targetDropOffImage", 10, boost::bind(targetDropOffHandler, name, _1));
+        }
+        rover.obstacle_subscriber = nh.subscribe<std_msgs::UInt8>("/"+name+"/obstacle", 10, boost::bind(obstacleHandler, name, _1));
+
+        std_msgs::UInt8 autonomous;
+        autonomous.data = 2;
+        rover.mode_publisher.publish(autonomous);
+    }
+
+    ros::Subscriber model_states_subscriber = nh.subscribe("/gazebo/model_states", 1, modelStatesHandler);
+    ros::Subscriber score_subscriber;
+    if (plugin_scoring) score_subscriber = nh.subscribe("/score", 1, scoreHandler);
+
+    // Simulated time starts at zero until gazebo publishes the first clock message
+    while (ros::ok() && ros::Time::now().isZero())
+    {
+        ros::WallDuration(0.1).sleep();
+        ros::spinOnce();
+    }
+    trial_start = ros::Time::now();
+    trial_duration = ros::Duration(duration);
+    last_coverage_update = trial_start;
+
+    while (ros::ok() && ros::Time::now() - trial_start < trial_duration)
+    {
+        ros::spinOnce();
+        ros::WallDuration(0.01).sleep();
+    }
+
+    writeResult(output_path, label);
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*!
+ * \brief   Row major 3x3 matrix stored as three Vec3 rows. Used for rotations that are applied to
+ *          many points, where building the matrix once is cheaper than repeated quaternion rotations.
+ * \class   Mat3
+ */
+
+#ifndef SHARED_MATH_MAT3_H
+#define SHARED_MATH_MAT3_H
+
+#include <cmath>
+#include "Vec3.h"
+#include "Quat.h"
+
+namespace shared_math
+{
+
+struct Mat3
+{
+    Vec3 r0;
+    Vec3 r1;
+    Vec3 r2;
+
+    // The default matrix is the identity
+    constexpr Mat3() : r0(1.0f, 0.0f, 0.0f), r1(0.0f, 1.0f, 0.0f), r2(0.0f, 0.0f, 1.0f) {}
+    constexpr Mat3(const Vec3& r0, const Vec3& r1, const Vec3& r2) : r0(r0), r1(r1), r2(r2) {}
+
+    constexpr Vec3 col0() const { return Vec3(r0.x, r1.x, r2.x); }
+    constexpr Vec3 col1() const { return Vec3(r0.y, r1.y, r2.y); }
+    constexpr Vec3 col2() const { return Vec3(r0.z, r1.z, r2.z); }
+
+    constexpr Mat3 transpose() const { return Mat3(col0(), col1(), col2()); }
+
+    static constexpr Mat3 fromQuat(const Quat& q)
+    {
+        return Mat3(Vec3(1.0f - 2.0f*(q.y*q.y + q.z*q.z), 2.0f*(q.x*q.y - q.w*q.z), 2.0f*(q.x*q.z + q.w*q.y)),
+                    Vec3(2.0f*(q.x*q.y + q.w*q.z), 1.0f - 2.0f*(q.x*q.x + q.z*q.z), 2.0f*(q.y*q.z - q.w*q.x)),
+                    Vec3(2.0f*(q.x*q.z - q.w*q.y), 2.0f*(q.y*q.z + q.w*q.x), 1.0f - 2.0f*(q.x*q.x + q.y*q.y)));
+    }
+
+    // Rotation of angle radians about axis (Rodrigues). The axis does not need to be normalised.
+    static Mat3 fromAxisAngle(const Vec3& axis, float angle)
+    {
+        return fromQuat(Quat::fromAxisAngle(axis, angle));
+    }
+};
+
+constexpr Vec3 operator*(const Mat3& m, const Vec3& v)
+{
+    return Vec3(dot(m.r0, v), dot(m.r1, v), dot(m.r2, v));
+}
+
+constexpr Mat3 operator*(const Mat3& a, const Mat3& b)
+{
+    return Mat3(Vec3(dot(a.r0, b.col0()), dot(a.r0, b.col1()), dot(a.r0, b.col2())),
+                Vec3(dot(a.r1, b.col0()), dot(a.r1, b.col1()), dot(a.r1, b.col2())),
+                Vec3(dot(a.r2, b.col0()), dot(a.r2, b.col1()), dot(a.r2, b.col2())));
+}
+
+}
+
+#endif // SHARED_MATH_MAT3_H
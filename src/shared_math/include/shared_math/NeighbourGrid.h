@@ -0,0 +1,259 @@
+/*!
+ * \brief   Uniform grid over the xy plane for points that move, such as the latest poses of the rovers.
+ *          Every point has a small non-negative integer key (a rover id or a table row). update() inserts the
+ *          key or moves it, and remove() takes it out. Both cost O(1): a key that stays inside its cell is
+ *          updated in place, otherwise it is swapped out of its old bucket and appended to the new one.
+ *          Only cells that contain something are stored, so the arena size does not have to be known.
+ *
+ *          Queries only look at the cells that can hold an answer. With the cell size set to the usual query
+ *          radius a radius query visits the 3x3 block of cells around the query point, so its cost grows with
+ *          the number of points nearby and not with the number of points in the grid.
+ *          Distances are compared squared, no square roots are taken.
+ *
+ *          Unlike UniformGrid, which holds discs that are never moved once placed, the cell size is fixed by
+ *          the caller and does not depend on what has been inserted.
+ * \class   NeighbourGrid
+ */
+
+#ifndef SHARED_MATH_NEIGHBOURGRID_H
+#define SHARED_MATH_NEIGHBOURGRID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace shared_math
+{
+
+class NeighbourGrid
+{
+public:
+    explicit NeighbourGrid(float cell_size = 1.0f) : cell_size(cell_size), count(0) {}
+
+    // Inserts key at (x, y), or moves it there if it is already in the grid. Negative keys are ignored.
+    void update(int key, float x, float y)
+    {
+        if (key < 0) return;
+        if (key >= static_cast<int>(slots.size())) slots.resize(key + 1);
+
+        std::uint64_t new_cell = cellKey(cell(x), cell(y));
+        Slot& slot = slots[key];
+        if (slot.present && slot.cell == new_cell)
+        {
+            Entry& entry = cells[new_cell][slot.index];
+            entry.x = x;
+            entry.y = y;
+            return;
+        }
+
+        if (slot.present) detach(key);
+        attach(key, x, y, new_cell);
+    }
+
+    void remove(int key)
+    {
+        if (contains(key)) detach(key);
+    }
+
+    bool contains(int key) const
+    {
+        return key >= 0 && key < static_cast<int>(slots.size()) && slots[key].present;
+    }
+
+    // Calls visit(key, distance_squared) for every point within radius of (x, y), in no particular order
+    template <typename Visitor>
+    void forEachWithin(float x, float y, float radius, Visitor visit) const
+    {
+        float radius_squared = radius*radius;
+        int reach = static_cast<int>(std::ceil(radius / cell_size));
+        int cx = cell(x);
+        int cy = cell(y);
+
+        for (int i = cx - reach; i <= cx + reach; i++)
+        {
+            for (int j = cy - reach; j <= cy + reach; j++)
+            {
+                CellMap::const_iterator it = cells.find(cellKey(i, j));
+                if (it == cells.end()) continue;
+
+                const std::vector<Entry>& bucket = it->second;
+                for (size_t k = 0; k < bucket.size(); k++)
+                {
+                    float dx = bucket[k].x - x;
+                    float dy = bucket[k].y - y;
+                    float distance_squared = dx*dx + dy*dy;
+                    if (distance_squared <= radius_squared) visit(bucket[k].key, distance_squared);
+                }
+            }
+        }
+    }
+
+    // Replaces keys with every key within radius of (x, y), in no particular order
+    void withinRadius(float x, float y, float radius, std::vector<int>& keys) const
+    {
+        keys.clear();
+        forEachWithin(x, y, radius, [&keys](int key, float) { keys.push_back(key); });
+    }
+
+    // Replaces keys with the k keys closest to (x, y), closest first. Fewer if the grid holds fewer than k points.
+    // Reuses a scratch buffer owned by the grid, so it does not allocate once warmed up. Like update(), it must
+    // not be called from two threads at once.
+    void nearest(float x, float y, size_t k, std::vector<int>& keys) const
+    {
+        keys.clear();
+        if (k == 0 || count == 0) return;
+
+        candidates.clear();
+        int cx = cell(x);
+        int cy = cell(y);
+
+        // Search rings of cells outwards from the query cell. A point outside ring r is more than r cells away,
+        // so once the k best candidates are all closer than that the search is finished.
+        size_t seen = 0;
+        for (int ring = 0; seen < count; ring++)
+        {
+            // Once the block is bigger than the number of occupied cells it is cheaper to look at all of them
+            size_t side = 2*ring + 1;
+            if (side*side > cells.size())
+            {
+                candidates.clear();
+                for (CellMap::const_iterator it = cells.begin(); it != cells.end(); ++it)
+                    collect(it->second, x, y, candidates);
+                break;
+            }
+
+            for (int i = cx - ring; i <= cx + ring; i++)
+            {
+                // Only the border of the block, the inside was searched by the previous rings
+                int step = (i == cx - ring || i == cx + ring) ? 1 : 2*ring;
+                for (int j = cy - ring; j <= cy + ring; j += step)
+                {
+                    CellMap::const_iterator it = cells.find(cellKey(i, j));
+                    if (it == cells.end()) continue;
+                    collect(it->second, x, y, candidates);
+                    seen += it->second.size();
+                }
+            }
+
+            if (candidates.size() >= k)
+            {
+                std::nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end());
+                float searched = ring*cell_size;
+                if (candidates[k - 1].first <= searched*searched) break;
+            }
+        }
+
+        if (candidates.size() > k)
+        {
+            std::nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end());
+            candidates.resize(k);
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (size_t i = 0; i < candidates.size(); i++) keys.push_back(candidates[i].second);
+    }
+
+    // Rebuilds the grid with a new cell size. Best set to the radius most queries use.
+    void setCellSize(float new_cell_size)
+    {
+        CellMap old_cells;
+        old_cells.swap(cells);
+        cell_size = new_cell_size;
+        count = 0;
+
+        for (size_t key = 0; key < slots.size(); key++) slots[key].present = false;
+        for (CellMap::const_iterator it = old_cells.begin(); it != old_cells.end(); ++it)
+            for (size_t k = 0; k < it->second.size(); k++)
+                update(it->second[k].key, it->second[k].x, it->second[k].y);
+    }
+
+    void clear()
+    {
+        cells.clear();
+        slots.clear();
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+    float cellSize() const { return cell_size; }
+
+private:
+    struct Entry
+    {
+        int key;
+        float x;
+        float y;
+    };
+
+    // Where a key is stored: its cell and its index in that cell's bucket
+    struct Slot
+    {
+        Slot() : present(false), cell(0), index(0) {}
+
+        bool present;
+        std::uint64_t cell;
+        size_t index;
+    };
+
+    typedef std::unordered_map<std::uint64_t, std::vector<Entry> > CellMap;
+
+    int cell(float v) const { return static_cast<int>(std::floor(v / cell_size)); }
+
+    static std::uint64_t cellKey(int i, int j)
+    {
+        // Shifted as unsigned, shifting a negative signed value is undefined
+        return (static_cast<std::uint64_t>(i) << 32) | static_cast<std::uint32_t>(j);
+    }
+
+    static void collect(const std::vector<Entry>& bucket, float x, float y, std::vector<std::pair<float, int> >& candidates)
+    {
+        for (size_t k = 0; k < bucket.size(); k++)
+        {
+            float dx = bucket[k].x - x;
+            float dy = bucket[k].y - y;
+            candidates.push_back(std::make_pair(dx*dx + dy*dy, bucket[k].key));
+        }
+    }
+
+    void attach(int key, float x, float y, std::uint64_t cell_key)
+    {
+        std::vector<Entry>& bucket = cells[cell_key];
+        Entry entry = { key, x, y };
+
+        Slot& slot = slots[key];
+        slot.present = true;
+        slot.cell = cell_key;
+        slot.index = bucket.size();
+        bucket.push_back(entry);
+        count++;
+    }
+
+    // Swaps the key with the last entry of its bucket and drops it
+    void detach(int key)
+    {
+        Slot& slot = slots[key];
+        CellMap::iterator it = cells.find(slot.cell);
+        std::vector<Entry>& bucket = it->second;
+
+        bucket[slot.index] = bucket.back();
+        slots[bucket[slot.index].key].index = slot.index;
+        bucket.pop_back();
+        if (bucket.empty()) cells.erase(it);
+
+        slot.present = false;
+        count--;
+    }
+
+    float cell_size;
+    size_t count;
+    CellMap cells;
+    std::vector<Slot> slots; // Indexed by key
+    mutable std::vector<std::pair<float, int> > candidates; // Scratch space for nearest()
+};
+
+}
+
+#endif // SHARED_MATH_NEIGHBOURGRID_H
@@ -0,0 +1,64 @@
+/*!
+ * \brief   Unit quaternion in <w, x, y, z> order, the same order as ROS geometry_msgs/Quaternion
+ *          is usually read in. Rotating a point does not build a matrix: rotate() applies
+ *          v' = 2(u.v)u + (s^2 - u.u)v + 2s(u x v) directly, which is constexpr.
+ * \class   Quat
+ */
+
+#ifndef SHARED_MATH_QUAT_H
+#define SHARED_MATH_QUAT_H
+
+#include <cmath>
+#include "Vec3.h"
+
+namespace shared_math
+{
+
+struct alignas(16) Quat
+{
+    float w;
+    float x;
+    float y;
+    float z;
+
+    // The default quaternion is the identity rotation
+    constexpr Quat() : w(1.0f), x(0.0f), y(0.0f), z(0.0f) {}
+    constexpr Quat(float w, float x, float y, float z) : w(w), x(x), y(y), z(z) {}
+
+    // Vector part of the quaternion
+    constexpr Vec3 vec() const { return Vec3(x, y, z); }
+
+    constexpr Quat conjugate() const { return Quat(w, -x, -y, -z); }
+
+    // Rotate v by this quaternion
+    constexpr Vec3 rotate(const Vec3& v) const
+    {
+        return 2.0f*dot(vec(), v)*vec() + (w*w - squaredNorm(vec()))*v + 2.0f*w*cross(vec(), v);
+    }
+
+    // Rotate v by the inverse of this (unit) quaternion
+    constexpr Vec3 inverseRotate(const Vec3& v) const { return conjugate().rotate(v); }
+
+    // Heading about the z axis in radians, the same value tf::Matrix3x3::getRPY returns as yaw
+    float yaw() const { return std::atan2(2.0f*(w*z + x*y), 1.0f - 2.0f*(y*y + z*z)); }
+
+    // angle in radians. The axis does not need to be normalised.
+    static Quat fromAxisAngle(const Vec3& axis, float angle)
+    {
+        Vec3 u = normalized(axis) * std::sin(angle/2.0f);
+        return Quat(std::cos(angle/2.0f), u.x, u.y, u.z);
+    }
+};
+
+// Hamilton product: (a*b).rotate(v) == a.rotate(b.rotate(v))
+constexpr Quat operator*(const Quat& a, const Quat& b)
+{
+    return Quat(a.w*b.w - a.x*b.x - a.y*b.y - a.z*b.z,
+                a.w*b.x + a.x*b.w + a.y*b.z - a.z*b.y,
+                a.w*b.y - a.x*b.z + a.y*b.w + a.z*b.x,
+                a.w*b.z + a.x*b.y - a.y*b.x + a.z*b.w);
+}
+
+}
+
+#endif // SHARED_MATH_QUAT_H
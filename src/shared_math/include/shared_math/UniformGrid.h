@@ -0,0 +1,119 @@
+/*!
+ * \brief   Uniform grid spatial hash over the xy plane for discs (a centre and a clearance radius).
+ *          Discs are bucketed by the cell that contains their centre. The cell size is twice the largest
+ *          radius inserted so far, so an overlap query only has to look at the 3x3 block of cells around
+ *          the query point (a bigger block if the query radius is larger than the cell). Only cells that
+ *          contain something are stored, so the arena size does not have to be known in advance.
+ *          Distances are compared squared, no square roots are taken.
+ *          If a disc larger than the current cell size allows is inserted, every disc is rehashed with the
+ *          new cell size. That happens at most a handful of times per layout.
+ * \class   UniformGrid
+ */
+
+#ifndef SHARED_MATH_UNIFORMGRID_H
+#define SHARED_MATH_UNIFORMGRID_H
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace shared_math
+{
+
+template <typename Payload>
+class UniformGrid
+{
+public:
+    struct Entry
+    {
+        float x;
+        float y;
+        float radius;
+        Payload payload;
+    };
+
+    // minimum_cell_size avoids tiny cells when only point-like (zero radius) discs have been inserted
+    explicit UniformGrid(float minimum_cell_size = 0.5f) : minimum_cell_size(minimum_cell_size), cell_size(minimum_cell_size), max_radius(0.0f), count(0) {}
+
+    void insert(float x, float y, float radius, const Payload& payload = Payload())
+    {
+        if (2.0f*radius > cell_size) rehash(2.0f*radius);
+
+        Entry entry = { x, y, radius, payload };
+        cells[key(cell(x), cell(y))].push_back(entry);
+        if (radius > max_radius) max_radius = radius;
+        count++;
+    }
+
+    // True if the disc at (x, y) with the given radius overlaps any stored disc
+    bool overlapsAny(float x, float y, float radius) const
+    {
+        int reach = static_cast<int>(std::ceil((radius + max_radius) / cell_size));
+        int cx = cell(x);
+        int cy = cell(y);
+
+        for (int i = cx - reach; i <= cx + reach; i++)
+        {
+            for (int j = cy - reach; j <= cy + reach; j++)
+            {
+                typename CellMap::const_iterator it = cells.find(key(i, j));
+                if (it == cells.end()) continue;
+
+                const std::vector<Entry>& bucket = it->second;
+                for (size_t k = 0; k < bucket.size(); k++)
+                {
+                    float dx = x - bucket[k].x;
+                    float dy = y - bucket[k].y;
+                    float r = radius + bucket[k].radius;
+                    if (dx*dx + dy*dy < r*r) return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void clear()
+    {
+        cells.clear();
+        cell_size = minimum_cell_size;
+        max_radius = 0.0f;
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+    float cellSize() const { return cell_size; }
+
+private:
+    typedef std::unordered_map<std::uint64_t, std::vector<Entry> > CellMap;
+
+    int cell(float v) const { return static_cast<int>(std::floor(v / cell_size)); }
+
+    static std::uint64_t key(int i, int j)
+    {
+        // Shifted as unsigned, shifting a negative signed value is undefined
+        return (static_cast<std::uint64_t>(i) << 32) | static_cast<std::uint32_t>(j);
+    }
+
+    void rehash(float new_cell_size)
+    {
+        CellMap old_cells;
+        old_cells.swap(cells);
+        cell_size = new_cell_size;
+
+        for (typename CellMap::const_iterator it = old_cells.begin(); it != old_cells.end(); ++it)
+            for (size_t k = 0; k < it->second.size(); k++)
+                cells[key(cell(it->second[k].x), cell(it->second[k].y))].push_back(it->second[k]);
+    }
+
+    float minimum_cell_size;
+    float cell_size;
+    float max_radius;
+    size_t count;
+    CellMap cells;
+};
+
+}
+
+#endif // SHARED_MATH_UNIFORMGRID_H
@@ -0,0 +1,62 @@
+/*!
+ * \brief   Fixed size 3D vector. Vec3 lives on the stack, is trivially copyable and every operation
+ *          that does not need a square root is constexpr so constant geometry (e.g. the IMU cube)
+ *          can be built at compile time.
+ *          The struct is padded to four floats and 16 byte aligned so a Vec3 fills exactly one SSE
+ *          register and arrays of them can be vectorised by the compiler.
+ * \class   Vec3
+ */
+
+#ifndef SHARED_MATH_VEC3_H
+#define SHARED_MATH_VEC3_H
+
+#include <cmath>
+
+namespace shared_math
+{
+
+struct alignas(16) Vec3
+{
+    float x;
+    float y;
+    float z;
+    float pad; // Unused. Keeps the layout at four floats.
+
+    constexpr Vec3() : x(0.0f), y(0.0f), z(0.0f), pad(0.0f) {}
+    constexpr Vec3(float x, float y, float z) : x(x), y(y), z(z), pad(0.0f) {}
+
+    Vec3& operator+=(const Vec3& v) { x += v.x; y += v.y; z += v.z; return *this; }
+    Vec3& operator-=(const Vec3& v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+    Vec3& operator*=(float s) { x *= s; y *= s; z *= s; return *this; }
+};
+
+constexpr Vec3 operator+(const Vec3& a, const Vec3& b) { return Vec3(a.x+b.x, a.y+b.y, a.z+b.z); }
+constexpr Vec3 operator-(const Vec3& a, const Vec3& b) { return Vec3(a.x-b.x, a.y-b.y, a.z-b.z); }
+constexpr Vec3 operator-(const Vec3& a) { return Vec3(-a.x, -a.y, -a.z); }
+constexpr Vec3 operator*(const Vec3& a, float s) { return Vec3(a.x*s, a.y*s, a.z*s); }
+constexpr Vec3 operator*(float s, const Vec3& a) { return Vec3(a.x*s, a.y*s, a.z*s); }
+constexpr Vec3 operator/(const Vec3& a, float s) { return Vec3(a.x/s, a.y/s, a.z/s); }
+
+constexpr float dot(const Vec3& a, const Vec3& b) { return a.x*b.x + a.y*b.y + a.z*b.z; }
+
+constexpr Vec3 cross(const Vec3& a, const Vec3& b)
+{
+    return Vec3(a.y*b.z - a.z*b.y,
+                a.z*b.x - a.x*b.z,
+                a.x*b.y - a.y*b.x);
+}
+
+constexpr float squaredNorm(const Vec3& a) { return dot(a, a); }
+
+inline float norm(const Vec3& a) { return std::sqrt(squaredNorm(a)); }
+
+// Returns the zero vector rather than NaNs when asked to normalise the zero vector
+inline Vec3 normalized(const Vec3& a)
+{
+    float n = norm(a);
+    return n > 0.0f ? a / n : Vec3();
+}
+
+}
+
+#endif // SHARED_MATH_VEC3_H
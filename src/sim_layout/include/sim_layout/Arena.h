@@ -0,0 +1,24 @@
+/*!
+ * \brief   Fixed dimensions of the competition arenas and the rovers' starting positions, shared by the GUI,
+ *          the layout generator and the world writer so every trial is set up the same way.
+ */
+
+#ifndef SIM_LAYOUT_ARENA_H
+#define SIM_LAYOUT_ARENA_H
+
+namespace sim_layout
+{
+
+const float PRELIM_ARENA_DIM = 15;  // meters
+const float FINAL_ARENA_DIM = 23.1; // meters
+
+const float ROVER_CLEARANCE = 0.45;           // meters
+const float COLLECTION_DISK_CLEARANCE = 0.5;  // meters
+
+// Standard swarm sizes. The names and starting positions of the rovers are in Rovers.h.
+const int PRELIM_ROVERS = 3;
+const int FINAL_ROVERS = 6;
+
+}
+
+#endif // SIM_LAYOUT_ARENA_H
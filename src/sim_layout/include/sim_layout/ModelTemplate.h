@@ -0,0 +1,22 @@
+/*!
+ * \brief   SDF templates for models that are generated rather than loaded from their own model directory. A template
+ *          is a complete SDF document with @PLACEHOLDER@ strings, filled in once per model instance.
+ */
+
+#ifndef SIM_LAYOUT_MODELTEMPLATE_H
+#define SIM_LAYOUT_MODELTEMPLATE_H
+
+#include <string>
+
+namespace sim_layout
+{
+
+// Reads a template. Returns false and sets error if it could not be read.
+bool loadModelTemplate(const std::string& path, std::string& sdf_template, std::string& error);
+
+// Replaces every occurrence of placeholder in text
+void fillPlaceholder(std::string& text, const std::string& placeholder, const std::string& value);
+
+}
+
+#endif // SIM_LAYOUT_MODELTEMPLATE_H
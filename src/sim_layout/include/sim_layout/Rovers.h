@@ -0,0 +1,39 @@
+/*!
+ * \brief   Names, starting positions and models of the simulated rovers, for swarms of any size.
+ *
+ *          Rover i is fully determined by its index. The first six keep the names and starting positions of the
+ *          competition rovers (achilles, aeneas, ...), so three and six rover trials are unchanged. Further rovers
+ *          are called swarmie6, swarmie7, ... and start on rings around the collection disk, one meter apart.
+ *
+ *          Every rover is built from the same SDF template, simulation/models/swarmie/model.sdf.template, with
+ *          @NAME@ replaced by the rover's name and @COLOR@ by its top plate material. The matching launch file is
+ *          launch/swarmie.launch.
+ */
+
+#ifndef SIM_LAYOUT_ROVERS_H
+#define SIM_LAYOUT_ROVERS_H
+
+#include <string>
+#include "ModelTemplate.h"
+
+namespace sim_layout
+{
+
+// Relative to SWARMATHON_APP_ROOT
+const char* const ROVER_TEMPLATE_PATH = "simulation/models/swarmie/model.sdf.template";
+const char* const ROVER_LAUNCH_PATH = "launch/swarmie.launch";
+
+std::string roverName(int index);
+
+// Where the rover starts, facing along +x
+void roverStartPosition(int index, float& x, float& y);
+
+// Gazebo material of the rover's top plate, so rovers can be told apart in gzclient
+std::string roverColor(int index);
+
+// The template (loaded with loadModelTemplate) with the placeholders filled in for rover index
+std::string roverSDF(const std::string& sdf_template, int index);
+
+}
+
+#endif // SIM_LAYOUT_ROVERS_H
@@ -0,0 +1,30 @@
+/*!
+ * \brief   SDF for the AprilTag target models. Every target, from a single tag "at<N>" to the piles "atags4_<k>",
+ *          "atags16_<k>" and "atags64_<k>", is generated from one template, simulation/models/atag/model.sdf.template.
+ *          Only the box size and the material differ. All the materials are in one script that refers to one
+ *          texture directory, so gazebo parses a single model resource group however many targets a layout has,
+ *          and the box geometry is shared by every target of the same kind.
+ */
+
+#ifndef SIM_LAYOUT_TAGS_H
+#define SIM_LAYOUT_TAGS_H
+
+#include <string>
+#include "ModelTemplate.h"
+
+namespace sim_layout
+{
+
+// Relative to SWARMATHON_APP_ROOT
+const char* const TAG_TEMPLATE_PATH = "simulation/models/atag/model.sdf.template";
+
+// True for the target model names used by the layouts
+bool isTagModel(const std::string& model_name);
+
+// The template (loaded with loadModelTemplate) filled in for a target model, named unique_id in gazebo.
+// Returns an empty string if model_name is not a target model.
+std::string tagSDF(const std::string& sdf_template, const std::string& model_name, const std::string& unique_id);
+
+}
+
+#endif // SIM_LAYOUT_TAGS_H
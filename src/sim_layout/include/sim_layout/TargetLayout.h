@@ -0,0 +1,112 @@
+/*!
+ * \brief   Reproducible target layouts for simulation trials. A layout is fully determined by its distribution,
+ *          its seed and the LayoutParameters, so a trial can be rebuilt from the seed logged when it ran.
+ *
+ *          Targets are placed by dart throwing (Poisson-disk sampling with per object radii): a location is drawn
+ *          uniformly from the part of the arena away from the walls and kept if its clearance disc does not overlap
+ *          anything placed or reserved so far. Occupancy is tested on a shared_math::UniformGrid.
+ *
+ *          The random numbers come from std::mt19937, whose output sequence is fixed by the standard, and are
+ *          mapped to floats here rather than with std::uniform_real_distribution, whose results differ between
+ *          standard library implementations.
+ *
+ *          generateLayouts() spreads a batch over worker threads. Layout i always uses seed first_seed + i,
+ *          so the batch is identical whatever the number of threads.
+ * \class   TargetLayoutGenerator
+ */
+
+#ifndef SIM_LAYOUT_TARGETLAYOUT_H
+#define SIM_LAYOUT_TARGETLAYOUT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sim_layout
+{
+
+enum Distribution
+{
+    UNIFORM,    // 256 single targets
+    CLUSTERED,  // 4 piles of 64
+    POWER_LAW   // 1 pile of 64, 4 of 16, 16 of 4 and 64 single targets
+};
+
+// "uniform", "clustered" and "powerlaw"
+const char* distributionName(Distribution distribution);
+bool parseDistribution(const std::string& name, Distribution& distribution);
+
+// An area targets must keep clear of, such as the collection disk or a rover's starting position
+struct ReservedArea
+{
+    float x;
+    float y;
+    float clearance;
+};
+
+struct PlacedTarget
+{
+    std::string model_name; // Target model, e.g. "at5" or "atags64_0" (see Tags.h)
+    std::string unique_id;  // Name of the model instance in gazebo
+    float x;
+    float y;
+    float clearance;
+};
+
+struct LayoutParameters
+{
+    // The defaults match the preliminary round arena. Clearances are xy plane radii in meters.
+    LayoutParameters();
+
+    float arena_dim;
+    float barrier_clearance;
+    float cluster_size_64_clearance;
+    float cluster_size_16_clearance;
+    float cluster_size_4_clearance;
+    float cluster_size_1_clearance;
+
+    // Proposals allowed per target before the layout is given up as too dense
+    int max_attempts;
+
+    std::vector<ReservedArea> reserved;
+
+    void reserve(float x, float y, float clearance);
+
+    // Reserves the collection disk and the starting positions of the first n_rovers rovers
+    void reserveStartingArea(int n_rovers);
+};
+
+struct TargetLayout
+{
+    Distribution distribution;
+    std::uint32_t seed;
+    std::vector<PlacedTarget> targets;
+
+    // Rejection sampling statistics
+    unsigned long proposals;
+    unsigned long rejections;
+
+    // False if a target could not be placed within max_attempts. error says which one.
+    bool complete;
+    std::string error;
+};
+
+class TargetLayoutGenerator
+{
+public:
+    TargetLayoutGenerator(const LayoutParameters& parameters = LayoutParameters());
+
+    TargetLayout generate(Distribution distribution, std::uint32_t seed) const;
+
+    // Layouts for seeds first_seed .. first_seed+count-1. thread_count 0 uses one thread per core.
+    std::vector<TargetLayout> generateLayouts(Distribution distribution, std::uint32_t first_seed, size_t count, unsigned thread_count = 0) const;
+
+    const LayoutParameters& parameters() const { return layout_parameters; }
+
+private:
+    LayoutParameters layout_parameters;
+};
+
+}
+
+#endif // SIM_LAYOUT_TARGETLAYOUT_H
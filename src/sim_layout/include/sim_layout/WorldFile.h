@@ -0,0 +1,48 @@
+/*!
+ * \brief   Writes a gazebo world file that contains every model of a trial. The models are added as <include>
+ *          elements to a copy of a template world (normally simulation/worlds/swarmathon.world), so gazebo
+ *          loads them all at startup instead of having each one spawned through a service call. Rovers and
+ *          targets are generated from their SDF templates and written into the world inline.
+ * \class   WorldModel
+ */
+
+#ifndef SIM_LAYOUT_WORLDFILE_H
+#define SIM_LAYOUT_WORLDFILE_H
+
+#include <string>
+#include <vector>
+#include "TargetLayout.h"
+
+namespace sim_layout
+{
+
+struct WorldModel
+{
+    std::string model_name; // Loaded from model://model_name
+    std::string unique_id;
+    float x, y, z;
+    float roll, pitch, yaw;
+    std::string sdf;        // If set, this model is written inline instead of loading model://model_name
+};
+
+// Appends the walls for the round, the ground plane model and the collection disk
+void appendArena(bool final_round, const std::string& ground_plane, std::vector<WorldModel>& models);
+
+// Appends rovers 0 to n_rovers-1 at their starting positions, generated from the rover SDF template (see Rovers.h)
+void appendRovers(const std::string& sdf_template, int n_rovers, std::vector<WorldModel>& models);
+
+// Appends the targets of a layout, resting on the ground and unrotated, generated from the tag SDF template (see Tags.h)
+void appendTargets(const std::string& tag_template, const TargetLayout& layout, std::vector<WorldModel>& models);
+
+// Inserts the models before the closing </world> of the template and writes the result to output_path.
+// A non empty physics_profile is passed to the SetupWorld plugin as its <profile> ("fast" for batch trials).
+// scoring_plugin adds the ScoringPlugin, which answers the rovers' pick up and drop off requests, so it is only
+// for worlds that are run without the GUI. tag_camera_plugin adds the TagCameraPlugin, which replaces the rendered
+// rover cameras with synthetic tag detections and needs the ScoringPlugin.
+// Returns false and sets error if either file could not be used.
+bool writeWorldFile(const std::string& template_path, const std::vector<WorldModel>& models, const std::string& output_path, std::string& error,
+                    const std::string& physics_profile = "", bool scoring_plugin = false, bool tag_camera_plugin = false);
+
+}
+
+#endif // SIM_LAYOUT_WORLDFILE_H
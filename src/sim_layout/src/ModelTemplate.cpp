@@ -0,0 +1,31 @@
+#include <sim_layout/ModelTemplate.h>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+namespace sim_layout
+{
+
+bool loadModelTemplate(const string& path, string& sdf_template, string& error)
+{
+    ifstream template_file(path.c_str());
+    if (!template_file)
+    {
+        error = "Could not read " + path;
+        return false;
+    }
+
+    stringstream contents;
+    contents << template_file.rdbuf();
+    sdf_template = contents.str();
+    return true;
+}
+
+void fillPlaceholder(string& text, const string& placeholder, const string& value)
+{
+    for (size_t position = text.find(placeholder); position != string::npos; position = text.find(placeholder, position + value.size()))
+        text.replace(position, placeholder.size(), value);
+}
+
+}
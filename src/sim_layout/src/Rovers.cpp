@@ -0,0 +1,77 @@
+#include <sim_layout/Rovers.h>
+#include <cmath>
+#include <sstream>
+
+using namespace std;
+
+namespace sim_layout
+{
+
+namespace
+{
+
+const int NAMED_ROVERS = 6;
+const char* const ROVER_NAMES[NAMED_ROVERS] = { "achilles", "aeneas", "ajax", "diomedes", "hector", "paris" };
+const float ROVER_START_X[NAMED_ROVERS] = { 0, -1, 1, 1, -1, 1 };
+const float ROVER_START_Y[NAMED_ROVERS] = { 1, 0, 0, 1, -1, -1 };
+
+// The named rovers keep their old colors
+const int N_COLORS = 10;
+const char* const ROVER_COLORS[N_COLORS] = { "Grey", "Yellow", "White", "FlatBlack", "Blue", "Red",
+                                             "Green", "Orange", "Purple", "Turquoise" };
+
+// Rings of unnamed rovers start outside the named rovers' positions and the spacing is kept above twice
+// ROVER_CLEARANCE, so no two rovers start touching.
+const float FIRST_RING_RADIUS = 2.5;  // meters
+const float RING_SPACING = 1.0;       // meters, between rings and between rovers on a ring
+
+}
+
+string roverName(int index)
+{
+    if (index < NAMED_ROVERS) return ROVER_NAMES[index];
+
+    ostringstream name;
+    name << "swarmie" << index;
+    return name.str();
+}
+
+void roverStartPosition(int index, float& x, float& y)
+{
+    if (index < NAMED_ROVERS)
+    {
+        x = ROVER_START_X[index];
+        y = ROVER_START_Y[index];
+        return;
+    }
+
+    // Find the ring the rover is on and its place on that ring
+    int place = index - NAMED_ROVERS;
+    float radius = FIRST_RING_RADIUS;
+    int capacity = (int)floor(2*M_PI*radius/RING_SPACING);
+    while (place >= capacity)
+    {
+        place -= capacity;
+        radius += RING_SPACING;
+        capacity = (int)floor(2*M_PI*radius/RING_SPACING);
+    }
+
+    float angle = 2*M_PI*place/capacity;
+    x = radius*cos(angle);
+    y = radius*sin(angle);
+}
+
+string roverColor(int index)
+{
+    return string("Gazebo/") + ROVER_COLORS[index % N_COLORS];
+}
+
+string roverSDF(const string& sdf_template, int index)
+{
+    string sdf = sdf_template;
+    fillPlaceholder(sdf, "@NAME@", roverName(index));
+    fillPlaceholder(sdf, "@COLOR@", roverColor(index));
+    return sdf;
+}
+
+}
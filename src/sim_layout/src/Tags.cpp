@@ -0,0 +1,42 @@
+#include <sim_layout/Tags.h>
+#include <cctype>
+
+using namespace std;
+
+namespace sim_layout
+{
+
+namespace
+{
+
+// Collision box of each kind of target, "width height thickness" in meters
+const char* tagSize(const string& model_name)
+{
+    if (model_name.size() > 2 && model_name.compare(0, 2, "at") == 0 && isdigit(model_name[2])) return "0.0763 0.05912 .001";
+    if (model_name.compare(0, 7, "atags4_") == 0) return "0.15275 0.11825 .001";
+    if (model_name.compare(0, 8, "atags16_") == 0) return "0.419 0.381 .010";
+    if (model_name.compare(0, 8, "atags64_") == 0) return "0.611 0.473 .001";
+    return NULL;
+}
+
+}
+
+bool isTagModel(const string& model_name)
+{
+    return tagSize(model_name) != NULL;
+}
+
+string tagSDF(const string& sdf_template, const string& model_name, const string& unique_id)
+{
+    const char* size = tagSize(model_name);
+    if (size == NULL) return "";
+
+    // The material script defines atag/<model_name> for every target model
+    string sdf = sdf_template;
+    fillPlaceholder(sdf, "@NAME@", unique_id);
+    fillPlaceholder(sdf, "@SIZE@", size);
+    fillPlaceholder(sdf, "@MATERIAL@", "atag/" + model_name);
+    return sdf;
+}
+
+}
@@ -0,0 +1,200 @@
+#include <sim_layout/TargetLayout.h>
+#include <sim_layout/Arena.h>
+#include <sim_layout/Rovers.h>
+#include <shared_math/UniformGrid.h>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+namespace sim_layout
+{
+
+namespace
+{
+
+// Places targets one at a time for a single layout
+class Placer
+{
+public:
+    Placer(const LayoutParameters& parameters, TargetLayout& layout) : parameters(parameters), layout(layout), engine(layout.seed)
+    {
+        for (size_t i = 0; i < parameters.reserved.size(); i++)
+            occupied.insert(parameters.reserved[i].x, parameters.reserved[i].y, parameters.reserved[i].clearance);
+    }
+
+    // Places count copies of the model named prefix + index for index = first_index, first_index+1, ...
+    // Returns false if one of them could not be placed.
+    bool place(const string& prefix, int first_index, int count, float clearance)
+    {
+        // d is the distance from the center of the arena to the boundary minus the barrier clearance,
+        // i.e. the region where this object's center can be placed
+        float d = parameters.arena_dim/2.0f - (parameters.barrier_clearance + clearance);
+
+        for (int i = first_index; i < first_index + count; i++)
+        {
+            ostringstream name;
+            name << prefix << i;
+
+            if (!placeOne(name.str(), d, clearance)) return false;
+        }
+
+        return true;
+    }
+
+private:
+    bool placeOne(const string& name, float d, float clearance)
+    {
+        for (int attempt = 0; attempt < parameters.max_attempts; attempt++)
+        {
+            float x = d - unitFloat()*2*d;
+            float y = d - unitFloat()*2*d;
+            layout.proposals++;
+
+            if (occupied.overlapsAny(x, y, clearance))
+            {
+                layout.rejections++;
+                continue;
+            }
+
+            occupied.insert(x, y, clearance);
+            PlacedTarget target = { name, name, x, y, clearance };
+            layout.targets.push_back(target);
+            return true;
+        }
+
+        ostringstream error;
+        error << "Could not place " << name << " after " << parameters.max_attempts << " attempts";
+        layout.error = error.str();
+        return false;
+    }
+
+    // Uniform in [0, 1) from the top 24 bits, which is all a float mantissa holds
+    float unitFloat()
+    {
+        return (engine() >> 8) * (1.0f/16777216.0f);
+    }
+
+    const LayoutParameters& parameters;
+    TargetLayout& layout;
+    mt19937 engine;
+    shared_math::UniformGrid<char> occupied;
+};
+
+}
+
+const char* distributionName(Distribution distribution)
+{
+    switch (distribution)
+    {
+    case UNIFORM: return "uniform";
+    case CLUSTERED: return "clustered";
+    case POWER_LAW: return "powerlaw";
+    }
+    return "unknown";
+}
+
+bool parseDistribution(const string& name, Distribution& distribution)
+{
+    if (name == "uniform") distribution = UNIFORM;
+    else if (name == "clustered") distribution = CLUSTERED;
+    else if (name == "powerlaw") distribution = POWER_LAW;
+    else return false;
+
+    return true;
+}
+
+LayoutParameters::LayoutParameters()
+{
+    // Values taken from the max dimension of the gazebo collision box for each object
+    arena_dim = PRELIM_ARENA_DIM;
+    barrier_clearance = 0.5; // Keeps targets from being placed too close to walls
+    cluster_size_64_clearance = 0.8;
+    cluster_size_16_clearance = 0.6;
+    cluster_size_4_clearance = 0.2;
+    cluster_size_1_clearance = 0.1;
+    max_attempts = 100000;
+}
+
+void LayoutParameters::reserve(float x, float y, float clearance)
+{
+    ReservedArea area = { x, y, clearance };
+    reserved.push_back(area);
+}
+
+void LayoutParameters::reserveStartingArea(int n_rovers)
+{
+    reserve(0, 0, COLLECTION_DISK_CLEARANCE);
+    for (int i = 0; i < n_rovers; i++)
+    {
+        float x, y;
+        roverStartPosition(i, x, y);
+        reserve(x, y, ROVER_CLEARANCE);
+    }
+}
+
+TargetLayoutGenerator::TargetLayoutGenerator(const LayoutParameters& parameters) : layout_parameters(parameters)
+{
+}
+
+TargetLayout TargetLayoutGenerator::generate(Distribution distribution, uint32_t seed) const
+{
+    TargetLayout layout;
+    layout.distribution = distribution;
+    layout.seed = seed;
+    layout.proposals = 0;
+    layout.rejections = 0;
+
+    const LayoutParameters& p = layout_parameters;
+    Placer placer(p, layout);
+
+    switch (distribution)
+    {
+    case UNIFORM:
+        layout.complete = placer.place("at", 0, 256, p.cluster_size_1_clearance);
+        break;
+
+    case CLUSTERED:
+        layout.complete = placer.place("atags64_", 0, 4, p.cluster_size_64_clearance);
+        break;
+
+    case POWER_LAW:
+        // The single targets use tags 192 through 255 to avoid duplication with the piles
+        layout.complete = placer.place("atags64_", 0, 1, p.cluster_size_64_clearance)
+                && placer.place("atags16_", 0, 4, p.cluster_size_16_clearance)
+                && placer.place("atags4_", 0, 16, p.cluster_size_4_clearance)
+                && placer.place("at", 192, 64, p.cluster_size_1_clearance);
+        break;
+    }
+
+    return layout;
+}
+
+vector<TargetLayout> TargetLayoutGenerator::generateLayouts(Distribution distribution, uint32_t first_seed, size_t count, unsigned thread_count) const
+{
+    vector<TargetLayout> layouts(count);
+
+    if (thread_count == 0) thread_count = max(1u, thread::hardware_concurrency());
+    if (thread_count > count) thread_count = count;
+
+    // Workers take the next unclaimed index, so slow (dense) layouts do not hold up a fixed share of the batch
+    atomic<size_t> next_index(0);
+    vector<thread> workers;
+    for (unsigned t = 0; t < thread_count; t++)
+    {
+        workers.push_back(thread([&]()
+        {
+            for (size_t i = next_index++; i < count; i = next_index++)
+                layouts[i] = generate(distribution, first_seed + i);
+        }));
+    }
+
+    for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+
+    return layouts;
+}
+
+}
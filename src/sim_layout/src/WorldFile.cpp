@@ -0,0 +1,131 @@
+#include <sim_layout/WorldFile.h>
+#include <sim_layout/Arena.h>
+#include <sim_layout/Rovers.h>
+#include <sim_layout/Tags.h>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+namespace sim_layout
+{
+
+void appendArena(bool final_round, const string& ground_plane, vector<WorldModel>& models)
+{
+    float arena_dim = final_round ? FINAL_ARENA_DIM : PRELIM_ARENA_DIM;
+    string barrier = final_round ? "barrier_final_round" : "barrier_prelim_round";
+
+    WorldModel arena[] =
+    {
+        { barrier, "Barrier_West", -arena_dim/2, 0, 0, 0, 0, 0 },
+        { barrier, "Barrier_North", 0, -arena_dim/2, 0, 0, 0, (float)M_PI/2 },
+        { barrier, "Barrier_East", arena_dim/2, 0, 0, 0, 0, 0 },
+        { barrier, "Barrier_South", 0, arena_dim/2, 0, 0, 0, (float)M_PI/2 },
+        { ground_plane, ground_plane, 0, 0, 0, 0, 0, 0 },
+        { "collection_disk", "collection_disk", 0, 0, 0, 0, 0, 0 }
+    };
+    models.insert(models.end(), arena, arena + sizeof(arena)/sizeof(arena[0]));
+}
+
+void appendRovers(const string& sdf_template, int n_rovers, vector<WorldModel>& models)
+{
+    for (int i = 0; i < n_rovers; i++)
+    {
+        WorldModel rover = { "swarmie", roverName(i), 0, 0, 0, 0, 0, 0, roverSDF(sdf_template, i) };
+        roverStartPosition(i, rover.x, rover.y);
+        models.push_back(rover);
+    }
+}
+
+void appendTargets(const string& tag_template, const TargetLayout& layout, vector<WorldModel>& models)
+{
+    for (size_t i = 0; i < layout.targets.size(); i++)
+    {
+        const PlacedTarget& target = layout.targets[i];
+        WorldModel model = { target.model_name, target.unique_id, target.x, target.y, 0, 0, 0, 0,
+                             tagSDF(tag_template, target.model_name, target.unique_id) };
+        models.push_back(model);
+    }
+}
+
+bool writeWorldFile(const string& template_path, const vector<WorldModel>& models, const string& output_path, string& error,
+                    const string& physics_profile, bool scoring_plugin, bool tag_camera_plugin)
+{
+    ifstream template_file(template_path.c_str());
+    if (!template_file)
+    {
+        error = "Could not read " + template_path;
+        return false;
+    }
+    stringstream template_contents;
+    template_contents << template_file.rdbuf();
+    string world = template_contents.str();
+
+    size_t world_end = world.rfind("</world>");
+    if (world_end == string::npos)
+    {
+        error = template_path + " has no </world> element";
+        return false;
+    }
+
+    if (!physics_profile.empty())
+    {
+        const string setup_world = "<plugin name=\"SetupWorld\" filename=\"libgazebo_plugins.so\"/>";
+        size_t plugin = world.find(setup_world);
+        if (plugin == string::npos)
+        {
+            error = template_path + " does not load the SetupWorld plugin";
+            return false;
+        }
+        world.replace(plugin, setup_world.size(), "<plugin name=\"SetupWorld\" filename=\"libgazebo_plugins.so\">\n"
+                                                  "      <profile>" + physics_profile + "</profile>\n"
+                                                  "    </plugin>");
+        world_end = world.rfind("</world>");
+    }
+
+    ostringstream includes;
+    if (scoring_plugin) includes << "    <plugin name=\"ScoringPlugin\" filename=\"libscoring_plugin.so\"/>\n\n";
+    if (tag_camera_plugin) includes << "    <plugin name=\"TagCameraPlugin\" filename=\"libtag_camera_plugin.so\"/>\n\n";
+    for (size_t i = 0; i < models.size(); i++)
+    {
+        const WorldModel& model = models[i];
+        ostringstream pose;
+        pose << "<pose>" << model.x << " " << model.y << " " << model.z << " " << model.roll << " " << model.pitch << " " << model.yaw << "</pose>";
+
+        if (!model.sdf.empty())
+        {
+            // The <model> element of the SDF document, with the pose added as its first child
+            size_t model_start = model.sdf.find("<model");
+            size_t model_end = model.sdf.rfind("</model>");
+            size_t tag_end = model.sdf.find(">", model_start);
+            if (model_start == string::npos || model_end == string::npos || tag_end > model_end)
+            {
+                error = "The SDF of " + model.unique_id + " has no <model> element";
+                return false;
+            }
+            includes << "    " << model.sdf.substr(model_start, tag_end + 1 - model_start) << "\n"
+                     << "      " << pose.str()
+                     << model.sdf.substr(tag_end + 1, model_end + 8 - (tag_end + 1)) << "\n\n";
+            continue;
+        }
+
+        includes << "    <include>\n"
+                 << "      <uri>model://" << model.model_name << "</uri>\n"
+                 << "      <name>" << model.unique_id << "</name>\n"
+                 << "      " << pose.str() << "\n"
+                 << "    </include>\n\n";
+    }
+    world.insert(world_end, includes.str() + "  ");
+
+    ofstream world_file(output_path.c_str());
+    if (!(world_file << world))
+    {
+        error = "Could not write " + output_path;
+        return false;
+    }
+
+    return true;
+}
+
+}
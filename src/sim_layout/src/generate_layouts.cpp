@@ -0,0 +1,182 @@
+// Command line front end for the layout generator.
+//
+// Prints one summary line per layout, or with --output-dir writes a complete world file per layout
+// (arena, rovers and targets) that gazebo can load directly:
+//
+//   rosrun sim_layout generate_layouts --distribution powerlaw --seed 1000 --count 5000 --output-dir /tmp/layouts
+
+#include <sim_layout/Arena.h>
+#include <sim_layout/Rovers.h>
+#include <sim_layout/Tags.h>
+#include <sim_layout/TargetLayout.h>
+#include <sim_layout/WorldFile.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace sim_layout;
+
+static void printUsage(const char* program)
+{
+    cerr << "Usage: " << program << " [options]\n"
+         << "  --distribution NAME  uniform, clustered or powerlaw (default uniform)\n"
+         << "  --seed N             seed of the first layout (default 1)\n"
+         << "  --count N            number of layouts, seeds N, N+1, ... (default 1)\n"
+         << "  --threads N          worker threads, 0 for one per core (default 0)\n"
+         << "  --final              use the final round arena and six rovers\n"
+         << "  --rovers N           number of rovers (default 3, or 6 with --final)\n"
+         << "  --ground NAME        ground plane model (default mars_ground_plane)\n"
+         << "  --template PATH      world to add the models to\n"
+         << "                       (default $SWARMATHON_APP_ROOT/simulation/worlds/swarmathon.world)\n"
+         << "  --rover-template PATH  rover SDF template\n"
+         << "                       (default $SWARMATHON_APP_ROOT/" << ROVER_TEMPLATE_PATH << ")\n"
+         << "  --tag-template PATH  target SDF template\n"
+         << "                       (default $SWARMATHON_APP_ROOT/" << TAG_TEMPLATE_PATH << ")\n"
+         << "  --output-dir DIR     write DIR/<distribution>_<seed>.world for each layout\n"
+         << "  --physics PROFILE    SetupWorld physics profile for the world files: default or fast\n"
+         << "  --scoring-plugin     score the world files with the ScoringPlugin instead of the GUI\n"
+         << "  --tag-camera         synthetic tag detections instead of rendered cameras (implies --scoring-plugin)\n"
+         << "  --targets            also print the position of every target\n";
+}
+
+int main(int argc, char** argv)
+{
+    Distribution distribution = UNIFORM;
+    unsigned long seed = 1;
+    unsigned long count = 1;
+    unsigned threads = 0;
+    bool final_round = false;
+    int n_rovers = 0;
+    bool print_targets = false;
+    bool scoring_plugin = false;
+    bool tag_camera = false;
+    string ground_plane = "mars_ground_plane";
+    string template_path;
+    string rover_template_path;
+    string tag_template_path;
+    string output_dir;
+    string physics_profile;
+
+    const char* app_root = getenv("SWARMATHON_APP_ROOT");
+    if (app_root)
+    {
+        template_path = string(app_root) + "/simulation/worlds/swarmathon.world";
+        rover_template_path = string(app_root) + "/" + ROVER_TEMPLATE_PATH;
+        tag_template_path = string(app_root) + "/" + TAG_TEMPLATE_PATH;
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        string option = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (option == "--distribution" && has_value)
+        {
+            if (!parseDistribution(argv[++i], distribution))
+            {
+                cerr << "Unknown distribution " << argv[i] << endl;
+                return 1;
+            }
+        }
+        else if (option == "--seed" && has_value) seed = strtoul(argv[++i], NULL, 10);
+        else if (option == "--count" && has_value) count = strtoul(argv[++i], NULL, 10);
+        else if (option == "--threads" && has_value) threads = strtoul(argv[++i], NULL, 10);
+        else if (option == "--final") final_round = true;
+        else if (option == "--rovers" && has_value) n_rovers = atoi(argv[++i]);
+        else if (option == "--ground" && has_value) ground_plane = argv[++i];
+        else if (option == "--template" && has_value) template_path = argv[++i];
+        else if (option == "--rover-template" && has_value) rover_template_path = argv[++i];
+        else if (option == "--tag-template" && has_value) tag_template_path = argv[++i];
+        else if (option == "--output-dir" && has_value) output_dir = argv[++i];
+        else if (option == "--physics" && has_value) physics_profile = argv[++i];
+        else if (option == "--scoring-plugin") scoring_plugin = true;
+        else if (option == "--tag-camera") tag_camera = scoring_plugin = true;
+        else if (option == "--targets") print_targets = true;
+        else
+        {
+            printUsage(argv[0]);
+            return option == "--help" ? 0 : 1;
+        }
+    }
+
+    if (!output_dir.empty() && template_path.empty())
+    {
+        cerr << "No template world: set SWARMATHON_APP_ROOT or pass --template" << endl;
+        return 1;
+    }
+
+    if (n_rovers <= 0) n_rovers = final_round ? FINAL_ROVERS : PRELIM_ROVERS;
+
+    string rover_template, tag_template;
+    if (!output_dir.empty())
+    {
+        string error;
+        if (!loadModelTemplate(rover_template_path, rover_template, error))
+        {
+            cerr << error << ": set SWARMATHON_APP_ROOT or pass --rover-template" << endl;
+            return 1;
+        }
+        if (!loadModelTemplate(tag_template_path, tag_template, error))
+        {
+            cerr << error << ": set SWARMATHON_APP_ROOT or pass --tag-template" << endl;
+            return 1;
+        }
+    }
+
+    LayoutParameters parameters;
+    parameters.arena_dim = final_round ? FINAL_ARENA_DIM : PRELIM_ARENA_DIM;
+    parameters.reserveStartingArea(n_rovers);
+
+    TargetLayoutGenerator generator(parameters);
+    vector<TargetLayout> layouts = generator.generateLayouts(distribution, seed, count, threads);
+
+    int failures = 0;
+    for (size_t i = 0; i < layouts.size(); i++)
+    {
+        const TargetLayout& layout = layouts[i];
+
+        cout << distributionName(distribution) << " seed " << layout.seed << ": "
+             << layout.targets.size() << " targets, " << layout.proposals << " proposals, "
+             << layout.rejections << " rejected";
+
+        if (!layout.complete)
+        {
+            cout << " (" << layout.error << ")" << endl;
+            failures++;
+            continue;
+        }
+
+        if (!output_dir.empty())
+        {
+            vector<WorldModel> models;
+            appendArena(final_round, ground_plane, models);
+            appendRovers(rover_template, n_rovers, models);
+            appendTargets(tag_template, layout, models);
+
+            ostringstream path;
+            path << output_dir << "/" << distributionName(distribution) << "_" << layout.seed << ".world";
+
+            string error;
+            if (!writeWorldFile(template_path, models, path.str(), error, physics_profile, scoring_plugin, tag_camera))
+            {
+                cout << " (" << error << ")" << endl;
+                failures++;
+                continue;
+            }
+            cout << " -> " << path.str();
+        }
+        cout << endl;
+
+        if (print_targets)
+        {
+            for (size_t j = 0; j < layout.targets.size(); j++)
+                cout << "  " << layout.targets[j].unique_id << " " << layout.targets[j].x << " " << layout.targets[j].y << endl;
+        }
+    }
+
+    return failures > 0 ? 1 : 0;
+}
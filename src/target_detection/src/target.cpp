@@ -126,6 +126,15 @@ void targetDetect(const sensor_msgs::ImageConstPtr& rawImage) {
                 tagDetected.tags.data.push_back(det->id);
                 tagDetected.image = *rawImage;
 
+                //Corners in the 320x240 detection image. The pose is left at zero since the camera is not calibrated.
+                shared_messages::TagDetection detection;
+                detection.id = det->id;
+                for (int corner = 0; corner < 4; corner++) {
+                    detection.corners[2*corner] = det->p[corner][0];
+                    detection.corners[2*corner + 1] = det->p[corner][1];
+                }
+                tagDetected.detections.push_back(detection);
+
                 //Publish detected tag
                 tagPublish.publish(tagDetected);
             }